@@ -0,0 +1,183 @@
+/* utf-8 */
+
+/**
+ * @file
+ * @brief Операции над битовыми масками.
+ * @details Этажи зданий и битовые доски высот хранятся масками, в которых бит k - это высота
+ * k + 1 или позиция k. Для GCC и Clang используются встроенные функции, для остальных
+ * компиляторов и при определённом BITS_NO_BUILTINS - таблицы из bits_table.h, который
+ * создаётся при сборке программой src/gen/bits_table.c. Наборы длиннее слова, например отметки улиц города, хранятся массивами
+ * unsigned long.
+ *
+ * @date создан 19.10.2026
+ * @author Nick Egorrov
+ * @copyright http://www.apache.org/licenses/LICENSE-2.0
+ */
+
+#ifndef _BITS_H
+#define _BITS_H
+
+#include <assert.h>
+#include <stdbool.h>
+#include "skyskrapers/bits_table.h"
+
+/* BITS_NO_BUILTINS включает таблицы и для GCC, чтобы их можно было проверить. */
+#if defined(__GNUC__) && !defined(BITS_NO_BUILTINS)
+#define BITS_BUILTINS
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Количество единичных битов. */
+static inline int
+bits_count(unsigned int mask)
+{
+#ifdef BITS_BUILTINS
+    return __builtin_popcount(mask);
+#else
+    return bits_table_count[mask & 0xffu] + bits_table_count[(mask >> 8) & 0xffu]
+           + bits_table_count[(mask >> 16) & 0xffu] + bits_table_count[mask >> 24];
+#endif
+}
+
+/** Номер младшего единичного бита, @p mask не должна быть нулевой. */
+static inline int
+bits_lowest(unsigned int mask)
+{
+    assert(mask != 0);
+#ifdef BITS_BUILTINS
+    return __builtin_ctz(mask);
+#else
+    int ret = 0;
+
+    for (; (mask & 0xffu) == 0; mask >>= 8) {
+        ret += 8;
+    }
+
+    return ret + bits_table_lowest[mask & 0xffu];
+#endif
+}
+
+/** Номер старшего единичного бита, @p mask не должна быть нулевой. */
+static inline int
+bits_highest(unsigned int mask)
+{
+    assert(mask != 0);
+#ifdef BITS_BUILTINS
+    return (int) (sizeof(unsigned int) * 8) - 1 - __builtin_clz(mask);
+#else
+    int ret = 0;
+
+    for (; (mask >> 8) != 0; mask >>= 8) {
+        ret += 8;
+    }
+
+    return ret + bits_table_highest[mask];
+#endif
+}
+
+/** Ровно один единичный бит. */
+static inline bool
+bits_is_single(unsigned int mask)
+{
+    return mask != 0 && (mask & (mask - 1)) == 0;
+}
+
+/** Высота по маске этажей с одним битом или 0, если битов больше или нет совсем. */
+static inline int
+bits_height(unsigned int mask)
+{
+    if (!bits_is_single(mask)) {
+        return 0;
+    }
+
+#ifdef BITS_BUILTINS
+    return __builtin_ctz(mask) + 1;
+#else
+    return bits_table_height[mask % BITS_TABLE_MODULO];
+#endif
+}
+
+/** Маска высот от @p bottom до @p top включительно, пустая при @p bottom > @p top. */
+static inline unsigned int
+bits_range(int bottom, int top)
+{
+    assert(bottom >= 0 && bottom <= BITS_TABLE_MAX_SIZE);
+    assert(top >= 0 && top <= BITS_TABLE_MAX_SIZE);
+    return bits_table_range[bottom][top];
+}
+
+/** Количество битов в слове битового набора. */
+#define BITS_WORD_SIZE ((int) (sizeof(unsigned long) * 8))
+
+/** Количество слов битового набора из @p n битов. */
+#define BITS_WORDS(n) (((n) + BITS_WORD_SIZE - 1) / BITS_WORD_SIZE)
+
+/** Устанавливает бит @p i набора @p set. */
+static inline void
+bits_set(unsigned long *set, int i)
+{
+    set[i / BITS_WORD_SIZE] |= 1ul << (i % BITS_WORD_SIZE);
+}
+
+/** Сбрасывает бит @p i набора @p set. */
+static inline void
+bits_reset(unsigned long *set, int i)
+{
+    set[i / BITS_WORD_SIZE] &= ~(1ul << (i % BITS_WORD_SIZE));
+}
+
+/** Бит @p i набора @p set установлен. */
+static inline bool
+bits_test(const unsigned long *set, int i)
+{
+    return (set[i / BITS_WORD_SIZE] & (1ul << (i % BITS_WORD_SIZE))) != 0;
+}
+
+/**
+ * Номер первого установленного бита набора @p set из @p size битов, начиная с @p from, или -1.
+ * Пустые слова пропускаются целиком, поэтому обход набора стоит порядка числа установленных
+ * битов.
+ */
+static inline int
+bits_next(const unsigned long *set, int size, int from)
+{
+    int w = from / BITS_WORD_SIZE;
+
+    if (from >= size) {
+        return -1;
+    }
+
+    unsigned long word = set[w] & (~0ul << (from % BITS_WORD_SIZE));
+
+    for (;;) {
+        if (word != 0) {
+#ifdef BITS_BUILTINS
+            int ret = w * BITS_WORD_SIZE + __builtin_ctzl(word);
+#else
+            int ret = w * BITS_WORD_SIZE;
+
+            for (; (word & 0xfful) == 0; word >>= 8) {
+                ret += 8;
+            }
+
+            ret += bits_table_lowest[word & 0xfful];
+#endif
+            return ret < size ? ret : -1;
+        }
+
+        if (++w >= BITS_WORDS(size)) {
+            return -1;
+        }
+
+        word = set[w];
+    }
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _BITS_H */
@@ -0,0 +1,101 @@
+/* utf-8 */
+
+/**
+ * @file
+ * @brief Кэш решённых головоломок.
+ * @details Головоломки, которые отличаются только поворотом или отражением, имеют одно и то же
+ * решение с точностью до того же преобразования. Поэтому ключом кэша служит канонический вектор
+ * подсказок - наименьший из восьми векторов, получаемых преобразованиями группы симметрий
+ * квадрата. Найденное решение переводится обратно в ориентацию запроса.
+ *
+ * Кэш не потокобезопасен, при совместном использовании доступ должен быть защищён снаружи.
+ *
+ * @date создан 19.10.2026
+ * @author Nick Egorrov
+ * @copyright http://www.apache.org/licenses/LICENSE-2.0
+ */
+
+#ifndef _CACHE_H
+#define _CACHE_H
+
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct _city city_t;
+
+typedef struct _cache cache_t;
+
+/**
+ * Статистика кэша.
+ */
+typedef struct _cache_stats {
+    /** Максимальное количество решений в кэше. */
+    int capacity;
+    /** Текущее количество решений в кэше. */
+    int entries;
+    /** Количество удачных поисков. */
+    unsigned long long hits;
+    /** Количество неудачных поисков. */
+    unsigned long long misses;
+    /** Количество решений, вытесненных из кэша. */
+    unsigned long long evictions;
+} cache_stats_t;
+
+/**
+ * Создаёт кэш решений.
+ *
+ * @param capacity Максимальное количество решений, при переполнении вытесняется давно не
+ * использованное решение.
+ * @return Новый кэш, который должен быть удалён функцией cache_free().
+ */
+extern cache_t *
+cache_new(int capacity);
+
+extern void
+cache_free(cache_t *cache);
+
+/**
+ * Ищет решение головоломки.
+ *
+ * @param cache Кэш.
+ * @param size Размер головоломки.
+ * @param clues Подсказки в порядке city_load_clues(), 4 * @p size элементов.
+ * @param [out] heights Высоты башен построчно, @p size * @p size элементов.
+ * @return true если решение найдено и записано в @p heights.
+ */
+extern bool
+cache_find(cache_t *cache, int size, const int *clues, int *heights);
+
+/**
+ * Сохраняет решение головоломки.
+ *
+ * @param cache Кэш.
+ * @param size Размер головоломки.
+ * @param clues Подсказки в порядке city_load_clues(), 4 * @p size элементов.
+ * @param heights Высоты башен построчно, @p size * @p size элементов.
+ */
+extern void
+cache_put(cache_t *cache, int size, const int *clues, const int *heights);
+
+extern void
+cache_get_stats(const cache_t *cache, cache_stats_t *stats);
+
+/**
+ * Решает головоломку с использованием кэша. Подсказки берутся из @p city, поэтому они должны
+ * быть загружены заранее функцией city_load_clues(). Если решение есть в кэше, то высоты башен
+ * устанавливаются без запуска решателя, иначе вызывается city_solve() и удачное решение
+ * сохраняется в кэш.
+ *
+ * @return true если головоломка решена.
+ */
+extern bool
+city_solve_cached(city_t *city, cache_t *cache);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _CACHE_H */
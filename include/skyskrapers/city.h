@@ -14,6 +14,8 @@
 #define _CITY_H
 
 #include <stdbool.h>
+#include <stdio.h>
+#include "skyskrapers/memory.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -25,6 +27,12 @@ typedef struct _street street_t;
 
 typedef struct _city city_t;
 
+typedef struct _solve_options solve_options_t;
+
+typedef struct _search search_t;
+
+typedef struct _street_cache street_cache_t;
+
 extern city_t *
 city_make(city_t *in, int size);
 
@@ -46,11 +54,149 @@ city_notify_of_tower_change(city_t *city, int x, int y);
 extern void
 city_notify_of_street_change(city_t *city, int side, int pos);
 
+/**
+ * Обновляет битовые доски высот после изменения этажей здания и дописывает изменение в
+ * изменения четырёх улиц через здание, см. city_t::removed и city_t::fixed. Если этажи
+ * вернулись, изменения этих улиц считаются неизвестными.
+ *
+ * @param city Головоломка.
+ * @param x Столбец здания.
+ * @param y Строка здания.
+ * @param changed Изменившиеся этажи битовыми флагами.
+ */
+extern void
+city_notify_of_options_change(city_t *city, int x, int y, int changed);
+
+/**
+ * Заново строит битовые доски высот и счётчики зданий по этажам всех зданий.
+ */
+extern void
+city_sync_towers(city_t *city);
+
+/**
+ * Забывает накопленные изменения улицы @p index, когда все эвристики ряда вернули false.
+ */
+extern void
+city_clear_delta(city_t *city, int index);
+
+/**
+ * Учитывает здание в счётчиках city_t::unsolved и city_t::empty. Вызывается с @p delta -1
+ * перед изменением здания и с @p delta 1 после него.
+ */
+extern void
+city_count_tower(city_t *city, const tower_t *tower, int delta);
+
+/**
+ * Обновляет состояние улицы, если оно устарело, и учитывает её в счётчике city_t::invalid.
+ *
+ * @return Улица верна.
+ */
+extern bool
+city_update_street(city_t *city, int index);
+
+/**
+ * Запись следа: этажи и высота здания до изменения.
+ */
+typedef struct _trail_entry {
+    /** Индекс здания в city_t::towers. */
+    int tower;
+    int options;
+    int height;
+} trail_entry_t;
+
+/**
+ * След изменений зданий. Пока след подключён к городу (city_t::trail), каждое изменение
+ * этажей записывается в него, и город можно вернуть к любой прошлой длине следа.
+ */
+typedef struct _trail {
+    trail_entry_t *entries;
+    int size;
+    int capacity;
+} trail_t;
+
+/**
+ * Освобождает записи следа, выросшего в городе @p city.
+ */
+extern void
+city_trail_free(city_t *city, trail_t *trail);
+
+/**
+ * Записывает в подключённый след состояние здания перед изменением, а в подключённый снимок -
+ * строку здания, если она ещё не сохранена.
+ */
+extern void
+city_trail_save(city_t *city, const tower_t *tower);
+
+/**
+ * Возвращает здания города к состоянию, когда след имел длину @p mark. Записи следа не
+ * удаляются, поэтому тот же след можно применить и к копии города. Изменённые ряды
+ * отмечаются для обновления.
+ *
+ * @param city Город, который был источником следа, или его копия.
+ * @param trail След.
+ * @param mark Длина следа, к которой возвращается город.
+ */
+extern void
+city_trail_restore(city_t *city, const trail_t *trail, int mark);
+
+/**
+ * Снимок города с копированием при записи. Пока снимок подключён к городу
+ * (city_t::snapshot), прежнее состояние строки зданий или улицы копируется в него перед
+ * первым изменением, а остальное не копируется вовсе.
+ */
+typedef struct _snapshot {
+    int size;
+    /** Память города, для которого создан снимок. */
+    memory_t *memory;
+    /** Прежние этажи зданий сохранённых строк, индексы как в city_t::towers. */
+    trail_entry_t *towers;
+    /** Прежний разбор сохранённых улиц. */
+    street_t *streets;
+    /** Прежние изменения сохранённых улиц, как city_t::removed и city_t::fixed. */
+    unsigned int *removed;
+    unsigned int *fixed;
+    /** Битовые наборы сохранённых строк и улиц. */
+    unsigned long *saved_rows;
+    unsigned long *saved_streets;
+    /** Копии city_t::need_update, city_t::need_handle и city_t::need_rescan. */
+    unsigned long *need_update;
+    unsigned long *need_handle;
+    unsigned long *need_rescan;
+    int unsolved;
+    int empty;
+    int invalid;
+    int outdated;
+} snapshot_t;
+
+/**
+ * Создаёт пустой снимок для городов размера city_t::size. Память снимка учитывается в
+ * памяти @p city, поэтому снимок освобождается раньше этого города.
+ */
+extern snapshot_t *
+city_snapshot_new(city_t *city);
+
+extern void
+city_snapshot_free(snapshot_t *snapshot);
+
+/**
+ * Подключает снимок к городу и запоминает его состояние. Копируются только счётчики и
+ * битовые наборы улиц, несколько слов.
+ */
+extern void
+city_snapshot_take(city_t *city, snapshot_t *snapshot);
+
+/**
+ * Возвращает город к состоянию подключённого снимка, переписывая только изменённые с тех пор
+ * строки и улицы. Снимок остаётся подключённым и снова пуст.
+ */
+extern void
+city_snapshot_restore(city_t *city);
+
 extern bool
-city_is_valid(const city_t *city);
+city_is_valid(city_t *city);
 
 extern bool
-city_is_solved(const city_t *city);
+city_is_solved(city_t *city);
 
 extern unsigned long long
 city_calc_iteration(const city_t *city);
@@ -58,6 +204,51 @@ city_calc_iteration(const city_t *city);
 extern tower_t *
 city_get_tower(const city_t *city, int side, int pos, int index);
 
+/**
+ * Выполняет один цикл эвристик.
+ *
+ * @return true если эвристики изменили город.
+ */
+extern bool
+city_solve_step(city_t *city);
+
+/**
+ * Выводит отладочное сообщение решателя в city_t::log.
+ */
+extern void
+city_log(const city_t *city, const char *format, ...);
+
+/**
+ * Проверяет ограничения решения, заданные city_solve_with().
+ *
+ * @param city Головоломка.
+ * @param node true для узла перебора, такие вызовы учитываются в
+ * solve_options_t::max_nodes.
+ * @return true если решение нужно прервать.
+ */
+extern bool
+city_check_budget(city_t *city, bool node);
+
+/**
+ * Проверяет флаг отмены и, если @p clock, крайний срок. Не меняет состояние решения, поэтому
+ * может вызываться из нескольких потоков.
+ */
+extern bool
+solve_options_expired(const solve_options_t *options, bool clock);
+
+/**
+ * Состояние решения с ограничениями.
+ */
+typedef struct _solve_control {
+    const solve_options_t *options;
+    /** Количество пройденных узлов перебора. */
+    unsigned long long nodes;
+    /** Счётчик вызовов city_check_budget() для редкой проверки часов. */
+    unsigned int ticks;
+    /** Решение прервано. */
+    bool expired;
+} solve_control_t;
+
 /**
  * Represents a puzzle.
  */
@@ -78,19 +269,79 @@ typedef struct _city {
      */
     street_t *streets;
     /**
-     * Array of flags indicating the need to update the corresponding instance from
-     * city_t::streets.
+     * Bit set of streets from city_t::streets that need to be updated, see bits_test() and
+     * bits_next().
      *
-     * Size is 4 times city_t::size.
+     * Size is BITS_WORDS(4 * city_t::size) words.
+     */
+    unsigned long *need_update;
+    /**
+     * Bit set of streets from city_t::streets that need to be processed.
+     *
+     * Size is BITS_WORDS(4 * city_t::size) words.
+     */
+    unsigned long *need_handle;
+    /**
+     * Bit set of streets whose changes in city_t::removed and city_t::fixed are unknown, so
+     * heuristics must rescan them.
+     *
+     * Size is BITS_WORDS(4 * city_t::size) words.
+     */
+    unsigned long *need_rescan;
+    /**
+     * Битовые доски высот по строкам: элемент (h - 1) * city_t::size + y содержит биты x
+     * зданий строки y, которым возможна высота h. Обновляются вместе с tower_t::options.
+     *
+     * Size is city_t::size ^ 2.
+     */
+    unsigned int *rows;
+    /**
+     * Битовые доски высот по столбцам: элемент (h - 1) * city_t::size + x содержит биты y
+     * зданий столбца x, которым возможна высота h.
+     *
+     * Size is city_t::size ^ 2.
+     */
+    unsigned int *cols;
+    /**
+     * Этажи, снятые со зданий улиц с последней неподвижной точки эвристик улицы: элемент
+     * i * city_t::size + k для здания k улицы i. Читается через street_get_removed().
+     *
+     * Size is 4 * city_t::size ^ 2.
      */
-    bool *need_update;
+    unsigned int *removed;
     /**
-     * Array of flags indicating the need to process the corresponding instance from
-     * city_t::streets.
+     * Здания улиц, построенные с последней неподвижной точки эвристик улицы: бит k элемента i
+     * для здания k улицы i. Читается через street_get_fixed().
      *
      * Size is 4 times city_t::size.
      */
-    bool *need_handle;
+    unsigned int *fixed;
+    /** Количество недостроенных зданий. */
+    int unsolved;
+    /** Количество зданий без допустимых этажей. */
+    int empty;
+    /** Количество неверных улиц среди обновлённых. */
+    int invalid;
+    /** Количество улиц, отмеченных в city_t::need_update. */
+    int outdated;
+    /** Методы цикла эвристик, битовые флаги из _solve_methods. */
+    unsigned int methods;
+    /** Порядок высот перебора из _value_orders. */
+    int value_order;
+    /** Поток для отладочных сообщений решателя, может быть NULL. */
+    FILE *log;
+    /** Ограничения решения, NULL если решение без ограничений. */
+    solve_control_t *control;
+    /** Состояние пошагового решения, NULL если решение не начато. Не копируется. */
+    search_t *search;
+    /** Кэш результатов эвристик для рядов, может быть NULL. Не принадлежит головоломке. */
+    street_cache_t *street_cache;
+    /** След изменений зданий, NULL если изменения не записываются. Не копируется. */
+    trail_t *trail;
+    /** Снимок для копирования при записи, NULL если снимка нет. Не копируется. */
+    snapshot_t *snapshot;
+    /** Распределитель и статистика памяти. Копия получает тот же распределитель. */
+    memory_t memory;
 
     bool must_free;
 } city_t;
@@ -0,0 +1,55 @@
+/* utf-8 */
+
+/**
+ * @file
+ * @brief Клиент сервера решений.
+ * @details Клиент держит одно соединение с сервером skyskrapersd и выполняет запросы
+ * последовательно. Для параллельных запросов нужно несколько клиентов.
+ *
+ * @date создан 19.10.2026
+ * @author Nick Egorrov
+ * @copyright http://www.apache.org/licenses/LICENSE-2.0
+ */
+
+#ifndef _CLIENT_H
+#define _CLIENT_H
+
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct _client client_t;
+
+/**
+ * Подключается к серверу.
+ *
+ * @param path Путь к сокету сервера, NULL означает PROTOCOL_DEFAULT_SOCKET.
+ * @return Клиент или NULL, если подключиться не удалось.
+ */
+extern client_t *
+client_connect(const char *path);
+
+extern void
+client_close(client_t *client);
+
+/**
+ * Отправляет головоломку серверу и ждёт ответ.
+ *
+ * @param client Клиент.
+ * @param size Размер головоломки от PROTOCOL_MIN_SIZE до PROTOCOL_MAX_SIZE.
+ * @param clues Подсказки в порядке city_load_clues(), 4 * @p size элементов.
+ * @param [out] heights Высоты башен построчно, @p size * @p size элементов. Заполняется только
+ * для ответа RESPONSE_SOLVED.
+ * @param [out] flags Флаги ответа, может быть NULL.
+ * @return Статус ответа или -1 при ошибке связи.
+ */
+extern int
+client_solve(client_t *client, int size, const int *clues, int *heights, int *flags);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _CLIENT_H */
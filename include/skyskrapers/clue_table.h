@@ -0,0 +1,64 @@
+/* utf-8 */
+
+/**
+ * @file
+ * @brief Таблицы ограничений для пары противоположных подсказок.
+ * @details Для ряда размера N с подсказкой a с ближнего края и b с дальнего края таблица
+ * хранит допустимые высоты каждой позиции и допустимые позиции самого высокого здания. Таблица
+ * строится перебором всех перестановок высот, поэтому она точная для отдельного ряда, но
+ * доступна только до размера CLUE_TABLE_MAX_SIZE. Для больших рядов используются
+ * аналитические границы.
+ *
+ * @date создан 19.10.2026
+ * @author Nick Egorrov
+ * @copyright http://www.apache.org/licenses/LICENSE-2.0
+ */
+
+#ifndef _CLUE_TABLE_H
+#define _CLUE_TABLE_H
+
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Максимальный размер ряда, для которого строится таблица. */
+#define CLUE_TABLE_MAX_SIZE 9
+
+typedef struct _clue_table {
+    int size;
+    /** Допустимые высоты позиции k для подсказок a и b битовыми флагами.
+     * Индекс (a * (size + 1) + b) * size + k. */
+    int *allowed;
+    /** Допустимые позиции самого высокого здания битовыми флагами.
+     * Индекс a * (size + 1) + b. */
+    int *tallest;
+} clue_table_t;
+
+/**
+ * Возвращает таблицу для ряда размера @p size, при первом обращении таблица строится.
+ * Построение безопасно при одновременном обращении из нескольких потоков.
+ *
+ * @return Таблица или NULL, если @p size больше CLUE_TABLE_MAX_SIZE.
+ */
+extern const clue_table_t *
+clue_table_get(int size);
+
+/**
+ * Вычисляет допустимые высоты для позиций ряда.
+ *
+ * @param size Размер ряда.
+ * @param near Подсказка с ближнего края, 0 если подсказки нет.
+ * @param far Подсказка с дальнего края, 0 если подсказки нет.
+ * @param [out] masks Допустимые высоты позиций от ближнего края, @p size элементов.
+ * @return false если подсказки несовместимы.
+ */
+extern bool
+clue_table_masks(int size, int near, int far, int *masks);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _CLUE_TABLE_H */
@@ -0,0 +1,91 @@
+/* utf-8 */
+
+/**
+ * @file
+ * @brief Индекс кэша с вытеснением давно не использованных записей.
+ * @details Индекс распределяет номера записей в массиве фиксированной ёмкости и хранит для них
+ * хэш-таблицу с цепочками и двусвязный список по свежести. Связи хранятся как номера записей,
+ * LRU_NONE означает отсутствие связи. Ключи и значения кэш хранит сам в своём массиве под
+ * теми же номерами, индекс сравнивает только хэши.
+ *
+ * @date создан 19.10.2026
+ * @author Nick Egorrov
+ * @copyright http://www.apache.org/licenses/LICENSE-2.0
+ */
+
+#ifndef _LRU_H
+#define _LRU_H
+
+#include "skyskrapers/cache.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LRU_NONE (-1)
+
+typedef struct _lru_link {
+    unsigned int hash;
+    /** Более свежая запись. */
+    int prev;
+    /** Более старая запись. */
+    int next;
+    /** Следующая запись в цепочке хэш-таблицы. */
+    int chain;
+} lru_link_t;
+
+typedef struct _lru {
+    int capacity;
+    /** Количество занятых записей, это записи с номерами от 0 до count - 1. */
+    int count;
+    unsigned int bucket_mask;
+    int *buckets;
+    lru_link_t *links;
+    /** Самая свежая запись. */
+    int head;
+    /** Самая старая запись, она вытесняется первой. */
+    int tail;
+    unsigned long long hits;
+    unsigned long long misses;
+    unsigned long long evictions;
+} lru_t;
+
+extern void
+lru_init(lru_t *lru, int capacity);
+
+extern void
+lru_destroy(lru_t *lru);
+
+/**
+ * Возвращает первую запись с хэшем @p hash или LRU_NONE. Следующие записи с тем же хэшем
+ * возвращает lru_next(), ключи записей проверяет кэш.
+ */
+extern int
+lru_first(const lru_t *lru, unsigned int hash);
+
+extern int
+lru_next(const lru_t *lru, int index);
+
+/**
+ * Делает запись самой свежей.
+ */
+extern void
+lru_touch(lru_t *lru, int index);
+
+/**
+ * Занимает запись для нового ключа с хэшем @p hash и делает её самой свежей. Если свободных
+ * записей нет, вытесняется самая старая, и кэш переписывает её ключ и значение.
+ *
+ * @return Номер записи.
+ */
+extern int
+lru_insert(lru_t *lru, unsigned int hash);
+
+extern void
+lru_get_stats(const lru_t *lru, cache_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _LRU_H */
@@ -0,0 +1,99 @@
+/* utf-8 */
+
+/**
+ * @file
+ * @brief Память головоломки.
+ * @details Вся память, которую головоломка держит во время решения, - здания, улицы, доски,
+ * снимки, стек перебора и след - берётся у распределителя головоломки и учитывается в её
+ * статистике. Копии головоломки получают тот же распределитель, но свою статистику.
+ *
+ * @date создан 19.10.2026
+ * @author Nick Egorrov
+ * @copyright http://www.apache.org/licenses/LICENSE-2.0
+ */
+
+#ifndef _MEMORY_H
+#define _MEMORY_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Распределитель памяти. Функция release получает размер, запрошенный у alloc, поэтому
+ * распределителю не нужны заголовки блоков. Функции вызываются только из потока, который
+ * решает головоломку: копии для проб высот в других потоках берут память у malloc().
+ */
+typedef struct _allocator {
+    /** Выделяет @p size байт, NULL если памяти нет. */
+    void *(*alloc)(void *context, size_t size);
+    /** Освобождает блок, выделенный alloc. */
+    void (*release)(void *context, void *ptr, size_t size);
+    /** Контекст, передаётся функциям первым аргументом. */
+    void *context;
+} allocator_t;
+
+/**
+ * Статистика памяти головоломки.
+ */
+typedef struct _memory_stats {
+    /** Занятые байты. */
+    size_t current;
+    /** Наибольшее количество занятых байт. */
+    size_t peak;
+    /** Количество выделений. */
+    unsigned long long allocs;
+    /** Количество освобождений. */
+    unsigned long long frees;
+} memory_stats_t;
+
+/**
+ * Распределитель со статистикой.
+ */
+typedef struct _memory {
+    allocator_t allocator;
+    memory_stats_t stats;
+} memory_t;
+
+/**
+ * Подключает распределитель и обнуляет статистику.
+ *
+ * @param allocator Распределитель или NULL для malloc() и free().
+ */
+extern void
+memory_init(memory_t *memory, const allocator_t *allocator);
+
+/**
+ * Выделяет память. Нехватка памяти проверяется assert, как и для malloc() в остальной
+ * библиотеке.
+ */
+extern void *
+memory_alloc(memory_t *memory, size_t size);
+
+/**
+ * Выделяет обнулённую память.
+ */
+extern void *
+memory_calloc(memory_t *memory, size_t count, size_t size);
+
+/**
+ * Увеличивает блок до @p size байт, сохраняя первые @p old_size байт.
+ *
+ * @param ptr Блок или NULL, если @p old_size равен нулю.
+ */
+extern void *
+memory_grow(memory_t *memory, void *ptr, size_t old_size, size_t size);
+
+/**
+ * Освобождает блок размером @p size, NULL пропускается.
+ */
+extern void
+memory_free(memory_t *memory, void *ptr, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _MEMORY_H */
@@ -21,6 +21,7 @@ extern "C" {
 
 typedef struct _street street_t;
 typedef struct _city city_t;
+typedef struct _tower tower_t;
 
 extern bool
 method_obvious(const street_t *street);
@@ -28,6 +29,76 @@ method_obvious(const street_t *street);
 extern bool
 method_exclude(const street_t *street);
 
+/**
+ * Ищет в ряду открытые и скрытые подмножества из 2..SUBSET_MAX зданий и исключает лишние высоты.
+ *
+ * @param street Проверяемый ряд
+ *
+ * @return true если были изменения в @p city.
+ */
+extern bool
+method_subset(const street_t *street);
+
+/**
+ * Ищет @p k элементов, объединение битовых масок которых содержит ровно @p k бит и
+ * пересекается с маской хотя бы одного другого элемента.
+ *
+ * @param sets Битовые маски элементов.
+ * @param count Количество элементов, не больше 32.
+ * @param k Размер подмножества.
+ * @param [out] members Номера найденных элементов битами.
+ * @return Объединение масок найденных элементов или 0, если подмножество не найдено.
+ */
+extern unsigned int
+method_find_subset(const unsigned int *sets, int count, int k, unsigned int *members);
+
+/**
+ * Оставляет зданиям ряда только высоты, которые входят хотя бы в одну расстановку разных высот.
+ * Работает по паросочетанию, сохранённому в street_t::matching с прошлого вызова.
+ *
+ * @param street Проверяемый ряд
+ *
+ * @return true если были изменения в @p city.
+ */
+extern bool
+method_alldiff(const street_t *street);
+
+/**
+ * Оставляет зданиям ряда только высоты, при которых с края ряда можно увидеть ровно столько
+ * зданий, сколько указано в подсказке. Заменяет частные правила method_first_of_two(),
+ * method_staircase(), method_step_down() и method_slope().
+ *
+ * @param street Проверяемый ряд
+ *
+ * @return true если были изменения в @p city.
+ */
+extern bool
+method_visibility(const street_t *street);
+
+/**
+ * Считает для здания @p index ряда с подсказкой, сколько расстановок высот из этажей ряда дают
+ * с края ряда ровно столько видимых зданий, сколько указано в подсказке, при каждой высоте
+ * здания. Условие разных высот учитывается так же частично, как в method_visibility().
+ *
+ * @param street Ряд с подсказкой.
+ * @param index Номер здания в ряду.
+ * @param [out] support Количество расстановок для высоты h в элементе h - 1, street_t::size
+ * элементов.
+ */
+extern void
+method_visibility_support(const street_t *street, int index, double *support);
+
+/**
+ * Выбирает следующую высоту точки выбора в порядке city_t::value_order.
+ *
+ * @param city Головоломка в состоянии точки выбора.
+ * @param tower Индекс здания в city_t::towers.
+ * @param remaining Непроверенные высоты битами, не пустые.
+ * @return Высота.
+ */
+extern int
+method_order_height(const city_t *city, int tower, int remaining);
+
 /**
  * Ограничивает высоту недостроенных зданий в ряду с подсказкой "2". Высота этих зданий не может
  * быть выше чем максимальная возможная высота первого здания минус один этаж.
@@ -48,7 +119,47 @@ method_step_down(const street_t *street);
 extern bool
 method_slope(const street_t *street);
 
+/**
+ * Ищет для каждой высоты "рыбу": k строк, в которых высота возможна только в тех же k
+ * столбцах, и исключает высоту из этих столбцов в остальных строках. То же для столбцов.
+ *
+ * @param city Головоломка.
+ *
+ * @return true если были изменения в @p city.
+ */
 extern bool
+method_fish(city_t *city);
+
+/**
+ * Проверяет сочетания решений, запомненные поиском city_t::search. Если выполнены все решения
+ * сочетания, кроме одного, оставшаяся высота исключается.
+ *
+ * @param city Головоломка.
+ *
+ * @return true если были изменения в @p city.
+ */
+extern bool
+method_nogood(city_t *city);
+
+/**
+ * Пробует каждую возможную высоту каждого недостроенного здания на копии города и исключает
+ * высоты, после которых копия становится ошибочной. Если копия решена, решение переносится в
+ * @p city. Количество проб и потоков задают ограничения решения city_t::control.
+ *
+ * @param city Головоломка.
+ *
+ * @return true если были изменения в @p city.
+ */
+extern bool
+method_probe(city_t *city);
+
+/**
+ * Выбирает здание для перебора. Сам перебор выполняет пошаговый поиск search_step().
+ *
+ * @param city Головоломка.
+ * @return Недостроенное здание или NULL, если все здания построены.
+ */
+extern tower_t *
 method_bruteforce(city_t *city);
 
 #ifdef __cplusplus
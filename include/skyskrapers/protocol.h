@@ -0,0 +1,79 @@
+/* utf-8 */
+
+/**
+ * @file
+ * @brief Протокол обмена с сервером решений.
+ * @details Сервер skyskrapersd и клиент обмениваются кадрами через локальный сокет. Кадр
+ * начинается с длины тела - 32-битного беззнакового целого в порядке little-endian, за
+ * которой следует тело указанной длины. Первые четыре байта тела - заголовок.
+ *
+ * Запрос на решение:
+ * @verbatim
+   0   версия протокола, PROTOCOL_VERSION
+   1   тип запроса, REQUEST_SOLVE
+   2   размер головоломки N
+   3   резерв, 0
+   4   4 * N байт подсказок в порядке city_load_clues()
+   @endverbatim
+ *
+ * Ответ:
+ * @verbatim
+   0   версия протокола, PROTOCOL_VERSION
+   1   статус, RESPONSE_SOLVED и т.д.
+   2   размер головоломки N
+   3   флаги, RESPONSE_FLAG_CACHED
+   4   N * N байт высот башен построчно, только для RESPONSE_SOLVED
+   @endverbatim
+ *
+ * @date создан 19.10.2026
+ * @author Nick Egorrov
+ * @copyright http://www.apache.org/licenses/LICENSE-2.0
+ */
+
+#ifndef _PROTOCOL_H
+#define _PROTOCOL_H
+
+#include "skyskrapers/skyskrapers.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define PROTOCOL_VERSION 1
+
+/** Размер заголовка тела кадра. */
+#define PROTOCOL_HEADER 4
+
+/** Размеры головоломки в запросе, те же, что решает библиотека. */
+#define PROTOCOL_MIN_SIZE CITY_MIN_SIZE
+#define PROTOCOL_MAX_SIZE CITY_MAX_SIZE
+
+/** Максимальная длина тела кадра. */
+#define PROTOCOL_MAX_BODY (PROTOCOL_HEADER + PROTOCOL_MAX_SIZE * PROTOCOL_MAX_SIZE)
+
+/** Сокет сервера по умолчанию. */
+#define PROTOCOL_DEFAULT_SOCKET "/tmp/skyskrapers.sock"
+
+enum _request_type {
+    REQUEST_SOLVE = 1
+};
+
+enum _response_status {
+    /** Головоломка решена, за заголовком следуют высоты башен. */
+    RESPONSE_SOLVED,
+    /** Решения нет. */
+    RESPONSE_UNSOLVED,
+    /** Запрос не распознан. */
+    RESPONSE_BAD_REQUEST,
+    /** Решение прервано по сроку сервера, запрос можно повторить в другом месте. */
+    RESPONSE_TIMEOUT
+};
+
+/** Решение взято из кэша сервера. */
+#define RESPONSE_FLAG_CACHED 0x01
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _PROTOCOL_H */
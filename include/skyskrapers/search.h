@@ -0,0 +1,107 @@
+/* utf-8 */
+
+/**
+ * @file
+ * @brief Пошаговый поиск решения.
+ * @details Поиск хранит точки выбора в собственном стеке в куче, а не на стеке вызовов,
+ * поэтому его можно остановить после любого шага, продолжить позже или сохранить. Вместо копии
+ * города точка выбора помнит длину следа изменений зданий, и при возврате к точке город
+ * откатывается по следу.
+ *
+ * @date создан 19.10.2026
+ * @author Nick Egorrov
+ * @copyright http://www.apache.org/licenses/LICENSE-2.0
+ */
+
+#ifndef _SEARCH_H
+#define _SEARCH_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "skyskrapers/skyskrapers.h"
+#include "skyskrapers/city.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct _search search_t;
+
+/**
+ * Создаёт поиск для головоломки. Стек, след и запрещённые сочетания поиска берутся из памяти
+ * головоломки, см. city_t::memory.
+ */
+extern search_t *
+search_new(city_t *city);
+
+extern void
+search_free(city_t *city, search_t *search);
+
+/**
+ * Выполняет один шаг поиска.
+ *
+ * @param city Головоломка, city_t::search должен быть создан.
+ */
+extern void
+search_step(city_t *city);
+
+/** Максимальное количество решений в запрещённом сочетании. */
+#define NOGOOD_MAX 8
+/** Максимальное количество хранимых запрещённых сочетаний, старые вытесняются. */
+#define NOGOOD_CAPACITY 256
+
+/**
+ * Запрещённое сочетание решений: здания не могут одновременно иметь эти высоты.
+ */
+typedef struct _nogood {
+    int size;
+    /** Индексы зданий в city_t::towers. */
+    int tower[NOGOOD_MAX];
+    int height[NOGOOD_MAX];
+} nogood_t;
+
+/**
+ * Точка выбора.
+ */
+typedef struct _choice {
+    /** Индекс здания перебора в city_t::towers. */
+    int tower;
+    /** Проверяемая высота, 0 до первой проверки. */
+    int height;
+    /** Высоты, которые ещё не проверены. */
+    int remaining;
+    /** Длина следа до перебора в этой точке. */
+    int mark;
+} choice_t;
+
+enum _search_state {
+    /** Цикл эвристик. */
+    SEARCH_PROPAGATE,
+    /** Эвристики ничего не дали, нужна новая точка выбора. */
+    SEARCH_BRANCH,
+    /** Проверка следующей высоты верхней точки выбора. */
+    SEARCH_NEXT,
+    /** Поиск закончен, результат в search_t::status. */
+    SEARCH_DONE
+};
+
+typedef struct _search {
+    int state;
+    solve_status_t status;
+    int depth;
+    int capacity;
+    choice_t *stack;
+    /** След изменений зданий, подключён к городу, пока стек не пуст. */
+    trail_t trail;
+    /** Запрещённые сочетания, NULL пока ни одного не найдено. */
+    nogood_t *nogoods;
+    int nogood_count;
+    /** Место для следующего сочетания при переполнении. */
+    int nogood_next;
+} search_t;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _SEARCH_H */
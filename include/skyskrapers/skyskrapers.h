@@ -14,6 +14,10 @@
 #define _SKYSKRAPERS_H
 
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <time.h>
+#include "skyskrapers/memory.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -21,18 +25,201 @@ extern "C" {
 
 typedef struct _city city_t;
 
+/** Наименьший размер головоломки. */
+#define CITY_MIN_SIZE 4
+/** Наибольший размер головоломки, который решает библиотека. */
+#define CITY_MAX_SIZE 25
+
+/**
+ * Результат city_solve_with().
+ */
+typedef enum _solve_status {
+    /** Головоломка решена. */
+    SOLVE_SOLVED,
+    /** Решения нет. */
+    SOLVE_UNSOLVABLE,
+    /** Решение прервано по сроку, количеству узлов перебора или флагу отмены. */
+    SOLVE_TIMEOUT,
+    /** Решение не закончено, см. city_solve_run(). */
+    SOLVE_RUNNING,
+    /** Внутренняя ошибка решателя: перебору не из чего выбирать. */
+    SOLVE_ERROR
+} solve_status_t;
+
+/**
+ * Ограничения решения. Перед использованием структуру нужно заполнить функцией
+ * solve_options_init().
+ */
+typedef struct _solve_options {
+    /** Крайний срок по часам timespec_get(TIME_UTC), нулевое значение - без срока. */
+    struct timespec deadline;
+    /** Максимальное количество узлов перебора, 0 - без ограничения. */
+    unsigned long long max_nodes;
+    /** Флаг отмены, отличное от нуля значение прерывает решение. Может быть NULL. */
+    const volatile int *cancel;
+    /** Максимальное количество проб высот перед каждым перебором, 0 - без ограничения. */
+    unsigned long probe_limit;
+    /** Количество потоков для проб высот, 0 и 1 - пробы в вызывающем потоке. */
+    int probe_threads;
+} solve_options_t;
+
+/**
+ * Методы решения для city_set_methods(), битовые флаги.
+ */
+enum _solve_methods {
+    METHOD_OBVIOUS = 1 << 0,
+    METHOD_EXCLUDE = 1 << 1,
+    METHOD_SUBSET = 1 << 2,
+    /** Полная согласованность условия "все высоты ряда разные", по умолчанию выключен. */
+    METHOD_ALLDIFF = 1 << 3,
+    METHOD_FIRST_OF_TWO = 1 << 4,
+    METHOD_STAIRCASE = 1 << 5,
+    METHOD_STEP_DOWN = 1 << 6,
+    METHOD_SLOPE = 1 << 7,
+    /** Точное ограничение видимости одной подсказки. */
+    METHOD_VISIBILITY = 1 << 8,
+    /** Рыба для каждой высоты по строкам и столбцам всего поля. */
+    METHOD_FISH = 1 << 9,
+    /** Пробы высот перед перебором, см. solve_options_t::probe_limit. Дороже нескольких
+     * узлов перебора, поэтому по умолчанию выключены. */
+    METHOD_PROBE = 1 << 10,
+    /** Запоминание и проверка сочетаний решений перебора, которые привели к ошибке. Сокращает
+     * перебор, но уменьшение каждого сочетания стоит нескольких узлов перебора, поэтому по
+     * умолчанию выключено. */
+    METHOD_NOGOOD = 1 << 11,
+    /** Частные правила видимости, которые заменяет METHOD_VISIBILITY. */
+    METHOD_VISIBILITY_RULES = METHOD_FIRST_OF_TWO | METHOD_STAIRCASE | METHOD_STEP_DOWN
+                              | METHOD_SLOPE,
+    METHOD_DEFAULT = METHOD_OBVIOUS | METHOD_EXCLUDE | METHOD_SUBSET | METHOD_VISIBILITY
+                     | METHOD_FISH
+};
+
+/**
+ * Порядок высот в точке выбора перебора для city_set_value_order().
+ */
+enum _value_orders {
+    /** От самой высокой к самой низкой. */
+    ORDER_DESCENDING,
+    /** Сначала высота, которая снимается с наименьшего числа зданий строки и столбца. */
+    ORDER_LCV,
+    /** Сначала высота, с которой совместимо больше всего расстановок видимости по подсказкам
+     * строки и столбца. */
+    ORDER_SUPPORT,
+    ORDER_COUNT
+};
+
+/**
+ * Создаёт головоломку.
+ *
+ * @param size Размер от CITY_MIN_SIZE до CITY_MAX_SIZE.
+ */
 extern city_t *
 city_new(int size);
 
 extern void
 city_free(city_t *city);
 
+/**
+ * Создаёт головоломку, вся память которой берётся у распределителя. Распределитель должен
+ * жить дольше головоломки и всех её копий.
+ *
+ * @param size Размер головоломки.
+ * @param allocator Распределитель или NULL для malloc() и free().
+ */
+extern city_t *
+city_new_with_allocator(int size, const allocator_t *allocator);
+
+/**
+ * Возвращает статистику памяти головоломки. Память копий учитывается в статистике копий.
+ */
 extern void
+city_get_memory_stats(const city_t *city, memory_stats_t *stats);
+
+/**
+ * Загружает подсказки и накладывает начальные ограничения.
+ *
+ * @return false если подсказки несовместимы и решения нет.
+ */
+extern bool
 city_load_clues(city_t *city, const int *clues);
 
+/**
+ * Заранее строит таблицы, которые иначе строятся при первой загрузке головоломки каждого
+ * размера. Полезно для долгоживущих процессов и обязательно для многопоточной работы на
+ * компиляторах без атомарных встроенных функций.
+ *
+ * @param max_size Максимальный размер головоломки, не больше CITY_MAX_SIZE.
+ */
+extern void
+city_prepare_tables(int max_size);
+
 extern bool
 city_solve(city_t *city);
 
+/**
+ * Сбрасывает все ограничения решения.
+ */
+extern void
+solve_options_init(solve_options_t *options);
+
+/**
+ * Устанавливает крайний срок через @p ms миллисекунд от текущего момента.
+ */
+extern void
+solve_options_set_timeout(solve_options_t *options, long ms);
+
+/**
+ * Решает головоломку с ограничениями. Срок и флаг отмены проверяются в каждом узле перебора и
+ * в каждом цикле эвристик. Если решение прервано, то город остаётся в состоянии, полученном
+ * эвристиками до начала перебора, и вызывающий может продолжить решение в другом месте.
+ *
+ * @param city Головоломка.
+ * @param options Ограничения или NULL.
+ * @return Результат решения.
+ */
+extern solve_status_t
+city_solve_with(city_t *city, const solve_options_t *options);
+
+/**
+ * Продвигает решение не более чем на @p max_steps шагов. Шаг - это один цикл эвристик,
+ * создание точки выбора или переход к следующей высоте точки выбора, поэтому один поток может
+ * по очереди решать много головоломок. Решение, прерванное по ограничениям, при следующем
+ * вызове начинается заново с текущего состояния.
+ *
+ * @param city Головоломка.
+ * @param max_steps Максимальное количество шагов.
+ * @return true если решение закончено, результат возвращает city_solve_result().
+ */
+extern bool
+city_solve_run(city_t *city, unsigned long max_steps);
+
+/**
+ * Возвращает результат решения, запущенного city_solve_run() или city_solve_with().
+ */
+extern solve_status_t
+city_solve_result(const city_t *city);
+
+/**
+ * Сохраняет головоломку вместе с незаконченным решением.
+ *
+ * @param city Головоломка.
+ * @param [out] buf Буфер, может быть NULL если @p size равен нулю.
+ * @param size Размер буфера.
+ * @return Размер сохранённых данных. Если он больше @p size, то буфер мал и данные записаны не
+ * полностью.
+ */
+extern size_t
+city_search_save(const city_t *city, void *buf, size_t size);
+
+/**
+ * Восстанавливает головоломку, сохранённую city_search_save(). Решение продолжается вызовом
+ * city_solve_run() или city_solve_with().
+ *
+ * @return Новая головоломка или NULL, если данные повреждены.
+ */
+extern city_t *
+city_search_load(const void *buf, size_t size);
+
 extern int **
 city_get_heights(const city_t *city);
 
@@ -42,6 +229,42 @@ city_set_heights(city_t *city, const int **heights);
 extern void
 city_print(const city_t *city);
 
+/**
+ * Устанавливает поток для отладочных сообщений решателя. По умолчанию сообщения выводятся в
+ * stdout.
+ *
+ * @param city Головоломка.
+ * @param log Поток для сообщений или NULL, чтобы отключить сообщения.
+ */
+extern void
+city_set_log(city_t *city, FILE *log);
+
+/**
+ * Выбирает методы, которые применяются в цикле эвристик. По умолчанию METHOD_DEFAULT.
+ * Перебор работает при любом наборе методов.
+ *
+ * @param city Головоломка.
+ * @param methods Битовые флаги из _solve_methods.
+ */
+extern void
+city_set_methods(city_t *city, unsigned int methods);
+
+extern unsigned int
+city_get_methods(const city_t *city);
+
+/**
+ * Выбирает порядок высот в точках выбора перебора. По умолчанию ORDER_DESCENDING. Порядок не
+ * сохраняется city_search_save(), после загрузки его нужно установить снова.
+ *
+ * @param city Головоломка.
+ * @param order Значение из _value_orders.
+ */
+extern void
+city_set_value_order(city_t *city, int order);
+
+extern int
+city_get_value_order(const city_t *city);
+
 #ifdef __cplusplus
 }
 #endif
@@ -44,9 +44,44 @@ street_get_tower(const street_t *street, int index);
 extern void
 street_fast_constraint(street_t *street);
 
+extern bool
+street_joint_constraint(street_t *street, street_t *opposite);
+
 extern bool
 street_update(street_t *street);
 
+extern unsigned int
+street_get_removed(const street_t *street, int index);
+
+extern unsigned int
+street_get_fixed(const street_t *street);
+
+/** Наибольший размер улицы в street_view_t. */
+#define STREET_VIEW_MAX_SIZE 32
+
+/**
+ * Этажи зданий улицы, собранные в непрерывный массив. Эвристика собирает улицу один раз
+ * функцией street_view_gather(), считает и меняет этажи в street_view_t::options, а
+ * street_view_scatter() записывает в здания только изменившиеся этажи с обычными
+ * уведомлениями города.
+ */
+typedef struct _street_view {
+    int size;
+    tower_t *towers[STREET_VIEW_MAX_SIZE];
+    /** Этажи зданий по порядку от края улицы. */
+    unsigned int options[STREET_VIEW_MAX_SIZE];
+    /** Высоты зданий, 0 для недостроенных. Не записываются обратно. */
+    int heights[STREET_VIEW_MAX_SIZE];
+    /** Этажи при сборе или последней записи. */
+    unsigned int gathered[STREET_VIEW_MAX_SIZE];
+} street_view_t;
+
+extern void
+street_view_gather(street_view_t *view, const street_t *street);
+
+extern bool
+street_view_scatter(street_view_t *view);
+
 typedef struct _hill {
     int first;
     int last;
@@ -77,6 +112,9 @@ typedef struct _street {
      * построенное здание выше максимальной высоты фрагмента.*/
     int hill_count;
     hill_t *hill_array;
+    /** Номер бита высоты, сопоставленной каждому зданию в method_alldiff(), -1 если нет.
+     * Размер city_t::size. */
+    int *matching;
 } street_t;
 
 #ifdef __cplusplus
@@ -0,0 +1,94 @@
+/* utf-8 */
+
+/**
+ * @file
+ * @brief Кэш результатов эвристик для рядов.
+ * @details При переборе и при решении головоломок одного размера одни и те же ряды, то есть
+ * подсказка и этажи зданий ряда, встречаются много раз. Кэш хранит для такого ряда этажи
+ * после всех эвристик ряда до неподвижной точки, и цикл эвристик берёт их из кэша вместо
+ * повторного вызова методов. Ключом служат включённые методы ряда, размер, подсказка, класс
+ * стороны (некоторые методы работают только для верхних и правых улиц) и этажи зданий ряда
+ * начиная от подсказки.
+ *
+ * Кэш не потокобезопасен. Один кэш можно подключить к нескольким головоломкам, если они
+ * решаются в одном потоке.
+ *
+ * @date создан 19.10.2026
+ * @author Nick Egorrov
+ * @copyright http://www.apache.org/licenses/LICENSE-2.0
+ */
+
+#ifndef _STREET_CACHE_H
+#define _STREET_CACHE_H
+
+#include <stdbool.h>
+#include "skyskrapers/cache.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct _city city_t;
+
+typedef struct _street street_t;
+
+typedef struct _street_cache street_cache_t;
+
+/**
+ * Создаёт кэш рядов.
+ *
+ * @param capacity Максимальное количество рядов, при переполнении вытесняется давно не
+ * использованный ряд.
+ * @return Новый кэш, который должен быть удалён функцией street_cache_free().
+ */
+extern street_cache_t *
+street_cache_new(int capacity);
+
+extern void
+street_cache_free(street_cache_t *cache);
+
+/**
+ * Ищет результат эвристик для ряда.
+ *
+ * @param cache Кэш.
+ * @param methods Включённые методы ряда.
+ * @param street Ряд, из него берутся размер, подсказка и сторона.
+ * @param options Этажи зданий ряда начиная от подсказки.
+ * @param [out] result Этажи зданий после эвристик.
+ * @return true если результат найден и записан в @p result.
+ */
+extern bool
+street_cache_find(street_cache_t *cache, unsigned int methods, const street_t *street,
+                  const int *options, int *result);
+
+/**
+ * Сохраняет результат эвристик для ряда.
+ *
+ * @param cache Кэш.
+ * @param methods Включённые методы ряда.
+ * @param street Ряд, из него берутся размер, подсказка и сторона.
+ * @param options Этажи зданий ряда до эвристик.
+ * @param result Этажи зданий после эвристик.
+ */
+extern void
+street_cache_put(street_cache_t *cache, unsigned int methods, const street_t *street,
+                 const int *options, const int *result);
+
+/**
+ * Статистика кэша рядов. Поля имеют тот же смысл, что и для кэша решений.
+ */
+extern void
+street_cache_get_stats(const street_cache_t *cache, cache_stats_t *stats);
+
+/**
+ * Подключает кэш рядов к головоломке, NULL отключает кэш. Кэш не принадлежит головоломке и
+ * не удаляется вместе с ней.
+ */
+extern void
+city_set_street_cache(city_t *city, street_cache_t *cache);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _STREET_CACHE_H */
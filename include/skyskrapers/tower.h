@@ -87,7 +87,7 @@ typedef struct _tower {
     int y;
     int height;
     int options;
-    int weight;
+    long long weight;
 } tower_t;
 
 #ifdef __cplusplus
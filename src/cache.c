@@ -0,0 +1,292 @@
+/* utf-8 */
+
+/**
+ * @file
+ * @brief Кэш решённых головоломок.
+ * @details Кэш состоит из массива записей фиксированной ёмкости и индекса lru.h, который
+ * находит записи по хэшу и выбирает запись для вытеснения.
+ *
+ * @date создан 19.10.2026
+ * @author Nick Egorrov
+ * @copyright http://www.apache.org/licenses/LICENSE-2.0
+ */
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include "skyskrapers/skyskrapers.h"
+#include "skyskrapers/city.h"
+#include "skyskrapers/street.h"
+#include "skyskrapers/tower.h"
+#include "skyskrapers/cache.h"
+#include "skyskrapers/lru.h"
+
+/** Количество преобразований группы симметрий квадрата: 4 поворота и 4 поворота отражения. */
+#define SYMMETRIES 8
+
+typedef struct _entry {
+    int size;
+    /** Канонические подсказки, 4 * size байт, и за ними решение в канонической ориентации,
+     * size * size байт. */
+    unsigned char *data;
+    /** Размер буфера entry_t::data. */
+    size_t data_size;
+} entry_t;
+
+struct _cache {
+    /** Номера записей, индекс тот же, что в cache_t::entries. */
+    lru_t index;
+    entry_t *entries;
+};
+
+/*+************************************
+ *  Симметрии
+ **************************************/
+
+/*
+ * Преобразование t состоит из необязательного отражения слева направо (бит 2) и последующих
+ * (t & 3) поворотов по часовой стрелке. Подсказки city_load_clues() идут по часовой стрелке
+ * начиная с верхней стороны, поэтому поворот сдвигает вектор на size позиций, а отражение
+ * меняет направление обхода.
+ */
+
+/** Индекс подсказки исходного вектора, которая после преобразования @p t займёт место @p j. */
+static int
+clue_source(int size, int t, int j)
+{
+    int len = 4 * size;
+    int i = j - (t & 3) * size;
+
+    if ((t & 4) != 0) {
+        i = size - 1 - i;
+    }
+
+    i %= len;
+    return i < 0 ? i + len : i;
+}
+
+/** Индекс башни исходной головоломки, которая после преобразования @p t займёт место (x, y). */
+static int
+cell_source(int size, int t, int x, int y)
+{
+    for (int r = t & 3; r > 0; r--) {
+        int tmp = x;
+        x = y;
+        y = size - 1 - tmp;
+    }
+
+    if ((t & 4) != 0) {
+        x = size - 1 - x;
+    }
+
+    return x + y * size;
+}
+
+/**
+ * Записывает в @p key наименьший из преобразованных векторов подсказок.
+ *
+ * @return Преобразование, дающее канонический вектор.
+ */
+static int
+canonical(int size, const int *clues, unsigned char *key)
+{
+    int best = 0;
+
+    for (int t = 1; t < SYMMETRIES; t++) {
+        for (int j = 0; j < 4 * size; j++) {
+            int a = clues[clue_source(size, t, j)];
+            int b = clues[clue_source(size, best, j)];
+
+            if (a != b) {
+                best = a < b ? t : best;
+                break;
+            }
+        }
+    }
+
+    for (int j = 0; j < 4 * size; j++) {
+        key[j] = (unsigned char) clues[clue_source(size, best, j)];
+    }
+
+    return best;
+}
+
+static unsigned int
+hash_key(int size, const unsigned char *key)
+{
+    /* FNV-1a */
+    unsigned int hash = 2166136261u;
+    hash = (hash ^ (unsigned int) size) * 16777619u;
+
+    for (int i = 0; i < 4 * size; i++) {
+        hash = (hash ^ key[i]) * 16777619u;
+    }
+
+    return hash;
+}
+
+/*+************************************
+ *  Поиск
+ **************************************/
+
+static int
+entry_find(const cache_t *cache, unsigned int hash, int size, const unsigned char *key)
+{
+    for (int index = lru_first(&cache->index, hash); index != LRU_NONE;
+            index = lru_next(&cache->index, index)) {
+        const entry_t *entry = &cache->entries[index];
+
+        if (entry->size == size && memcmp(entry->data, key, 4 * (size_t) size) == 0) {
+            return index;
+        }
+    }
+
+    return LRU_NONE;
+}
+
+/*+************************************
+ *  PUBLIC
+ **************************************/
+
+cache_t *
+cache_new(int capacity)
+{
+    assert(capacity > 0);
+    cache_t *ret = malloc(sizeof(cache_t));
+    assert(ret != NULL);
+    lru_init(&ret->index, capacity);
+    ret->entries = calloc((size_t) capacity, sizeof(entry_t));
+    assert(ret->entries != NULL);
+    return ret;
+}
+
+void
+cache_free(cache_t *cache)
+{
+    assert(cache != NULL);
+
+    for (int i = 0; i < cache->index.count; i++) {
+        free(cache->entries[i].data);
+    }
+
+    free(cache->entries);
+    lru_destroy(&cache->index);
+    free(cache);
+}
+
+bool
+cache_find(cache_t *cache, int size, const int *clues, int *heights)
+{
+    assert(cache != NULL);
+    assert(clues != NULL);
+    assert(heights != NULL);
+    assert(size > 0 && size <= 255);
+    unsigned char key[4 * 255];
+    int t = canonical(size, clues, key);
+    int index = entry_find(cache, hash_key(size, key), size, key);
+
+    if (index == LRU_NONE) {
+        cache->index.misses++;
+        return false;
+    }
+
+    cache->index.hits++;
+    lru_touch(&cache->index, index);
+    const unsigned char *solution = cache->entries[index].data + 4 * size;
+
+    for (int y = 0; y < size; y++) {
+        for (int x = 0; x < size; x++) {
+            heights[cell_source(size, t, x, y)] = solution[x + y * size];
+        }
+    }
+
+    return true;
+}
+
+void
+cache_put(cache_t *cache, int size, const int *clues, const int *heights)
+{
+    assert(cache != NULL);
+    assert(clues != NULL);
+    assert(heights != NULL);
+    assert(size > 0 && size <= 255);
+    unsigned char key[4 * 255];
+    int t = canonical(size, clues, key);
+    unsigned int hash = hash_key(size, key);
+    int index = entry_find(cache, hash, size, key);
+
+    if (index != LRU_NONE) {
+        lru_touch(&cache->index, index);
+    } else {
+        index = lru_insert(&cache->index, hash);
+        entry_t *entry = &cache->entries[index];
+        size_t need = 4 * (size_t) size + (size_t) size * (size_t) size;
+
+        if (entry->data_size < need) {
+            free(entry->data);
+            entry->data = malloc(need);
+            assert(entry->data != NULL);
+            entry->data_size = need;
+        }
+
+        entry->size = size;
+        memcpy(entry->data, key, 4 * (size_t) size);
+    }
+
+    unsigned char *solution = cache->entries[index].data + 4 * size;
+
+    for (int y = 0; y < size; y++) {
+        for (int x = 0; x < size; x++) {
+            solution[x + y * size] = (unsigned char) heights[cell_source(size, t, x, y)];
+        }
+    }
+}
+
+void
+cache_get_stats(const cache_t *cache, cache_stats_t *stats)
+{
+    assert(cache != NULL);
+    lru_get_stats(&cache->index, stats);
+}
+
+bool
+city_solve_cached(city_t *city, cache_t *cache)
+{
+    assert(city != NULL);
+    assert(cache != NULL);
+    int size = city->size;
+    size_t sz = (size_t) size;
+    int *clues = calloc(4 * sz + sz * sz, sizeof(int));
+    assert(clues != NULL);
+    int *heights = clues + 4 * sz;
+    bool solved;
+
+    for (int i = 0; i < 4 * size; i++) {
+        clues[i] = street_get_clue(&city->streets[i]);
+    }
+
+    if (cache_find(cache, size, clues, heights)) {
+        for (int y = 0; y < size; y++) {
+            for (int x = 0; x < size; x++) {
+                tower_set_height(city_get_tower(city, TOP, x, y), heights[x + y * size]);
+            }
+        }
+
+        solved = city_is_solved(city);
+    } else {
+        solved = city_solve(city);
+
+        if (solved) {
+            for (int y = 0; y < size; y++) {
+                for (int x = 0; x < size; x++) {
+                    heights[x + y * size] = tower_get_height(city_get_tower(city, TOP, x, y));
+                }
+            }
+
+            cache_put(cache, size, clues, heights);
+        }
+    }
+
+    free(clues);
+    return solved;
+}
@@ -18,24 +18,39 @@
 #include "skyskrapers/city.h"
 #include "skyskrapers/street.h"
 #include "skyskrapers/tower.h"
+#include "skyskrapers/search.h"
+#include "skyskrapers/clue_table.h"
+#include "skyskrapers/bits.h"
 
-city_t *
-city_make(city_t *in, int size)
+static city_t *
+city_make_with(city_t *in, int size, const allocator_t *allocator)
 {
+    assert(size >= CITY_MIN_SIZE && size <= CITY_MAX_SIZE);
     city_t *ret;
+    memory_t memory;
+    memory_init(&memory, allocator);
 
     if (in == 0) {
-        ret = malloc(sizeof(city_t));
+        ret = memory_alloc(&memory, sizeof(city_t));
         ret->must_free = true;
     } else {
         ret = in;
         ret->must_free = false;
     }
 
+    ret->memory = memory;
     ret->size = size;
     ret->mask = tower_get_mask(1, size);
+    ret->methods = METHOD_DEFAULT;
+    ret->value_order = ORDER_DESCENDING;
+    ret->log = stdout;
+    ret->control = NULL;
+    ret->search = NULL;
+    ret->street_cache = NULL;
+    ret->trail = NULL;
+    ret->snapshot = NULL;
     size_t sz = (size_t) size;
-    ret->towers = malloc(sz * sz * sizeof(tower_t));
+    ret->towers = memory_alloc(&ret->memory, sz * sz * sizeof(tower_t));
 
     for (int x = 0; x < size; x++) {
         for (int y = 0; y < size; y++) {
@@ -43,28 +58,62 @@ city_make(city_t *in, int size)
         }
     }
 
-    ret->need_update = malloc(4 * sz * sizeof(bool));
-    ret->need_handle = malloc(4 * sz * sizeof(bool));
-    ret->streets = malloc(4 * sz * sizeof(street_t));
+    size_t words = (size_t) BITS_WORDS(4 * size);
+    ret->need_update = memory_calloc(&ret->memory, words, sizeof(unsigned long));
+    ret->need_handle = memory_calloc(&ret->memory, words, sizeof(unsigned long));
+    ret->need_rescan = memory_calloc(&ret->memory, words, sizeof(unsigned long));
+    ret->streets = memory_alloc(&ret->memory, 4 * sz * sizeof(street_t));
+    ret->rows = memory_alloc(&ret->memory, sz * sz * sizeof(unsigned int));
+    ret->cols = memory_alloc(&ret->memory, sz * sz * sizeof(unsigned int));
+    ret->removed = memory_calloc(&ret->memory, 4 * sz * sz, sizeof(unsigned int));
+    ret->fixed = memory_calloc(&ret->memory, 4 * sz, sizeof(unsigned int));
+
+    for (size_t i = 0; i < sz * sz; i++) {
+        ret->rows[i] = (1u << sz) - 1u;
+        ret->cols[i] = (1u << sz) - 1u;
+    }
 
     for (int side = 0; side < 4; side ++) {
         for (int pos = 0; pos < size; pos ++) {
             int i = side * size + pos;
-            ret->need_update[i] = false;
-            ret->need_handle[i] = false;
             street_make(&ret->streets[i], ret, side, pos);
+            bits_set(ret->need_rescan, i);
         }
     }
 
+    ret->unsolved = size * size;
+    ret->empty = 0;
+    ret->invalid = 0;
+    ret->outdated = 0;
     return ret;
 }
 
+city_t *
+city_make(city_t *in, int size)
+{
+    return city_make_with(in, size, NULL);
+}
+
 city_t *
 city_new(int size)
 {
     return city_make(0, size);
 }
 
+city_t *
+city_new_with_allocator(int size, const allocator_t *allocator)
+{
+    return city_make_with(0, size, allocator);
+}
+
+void
+city_get_memory_stats(const city_t *city, memory_stats_t *stats)
+{
+    assert(city != NULL);
+    assert(stats != NULL);
+    *stats = city->memory.stats;
+}
+
 void
 city_free(city_t *city)
 {
@@ -74,18 +123,32 @@ city_free(city_t *city)
         street_free(&city->streets[i]);
     }
 
-    free(city->streets);
-    free(city->need_update);
-    free(city->need_handle);
+    memory_t *memory = &city->memory;
+    size_t sz = (size_t) city->size;
+    size_t words = (size_t) BITS_WORDS(4 * city->size) * sizeof(unsigned long);
+    memory_free(memory, city->streets, 4 * sz * sizeof(street_t));
+    memory_free(memory, city->need_update, words);
+    memory_free(memory, city->need_handle, words);
+    memory_free(memory, city->need_rescan, words);
+    memory_free(memory, city->rows, sz * sz * sizeof(unsigned int));
+    memory_free(memory, city->cols, sz * sz * sizeof(unsigned int));
+    memory_free(memory, city->removed, 4 * sz * sz * sizeof(unsigned int));
+    memory_free(memory, city->fixed, 4 * sz * sizeof(unsigned int));
 
     for (int i = 0; i < city->size * city->size; i ++) {
         tower_free(&city->towers[i]);
     }
 
-    free(city->towers);
+    memory_free(memory, city->towers, sz * sz * sizeof(tower_t));
+
+    if (city->search != NULL) {
+        search_free(city, city->search);
+    }
 
     if (city->must_free) {
-        free(city);
+        /* Сама головоломка освобождается последней, статистика уже не нужна. */
+        memory_t last = *memory;
+        memory_free(&last, city, sizeof(city_t));
     }
 }
 
@@ -96,25 +159,87 @@ city_copy(city_t *dst, const city_t *src)
     city_t *ret = dst;
 
     if (dst == 0) {
-        ret = city_make(0, src->size);
+        ret = city_make_with(0, src->size, &src->memory.allocator);
     }
 
     ret->size = src->size;
     ret->mask = src->mask;
+    ret->methods = src->methods;
+    ret->value_order = src->value_order;
+    ret->log = src->log;
+    ret->control = src->control;
+    ret->street_cache = src->street_cache;
+    ret->unsolved = src->unsolved;
+    ret->empty = src->empty;
+    ret->invalid = src->invalid;
+    ret->outdated = src->outdated;
 
     for (int i = 0; i < src->size * src->size; i ++) {
         tower_copy(&ret->towers[i], &src->towers[i]);
     }
 
+    size_t boards = (size_t) (src->size * src->size) * sizeof(unsigned int);
+    memcpy(ret->rows, src->rows, boards);
+    memcpy(ret->cols, src->cols, boards);
+    memcpy(ret->removed, src->removed, 4 * boards);
+    memcpy(ret->fixed, src->fixed, (size_t) (4 * src->size) * sizeof(unsigned int));
+
+    size_t words = (size_t) BITS_WORDS(4 * src->size) * sizeof(unsigned long);
+    memcpy(ret->need_update, src->need_update, words);
+    memcpy(ret->need_handle, src->need_handle, words);
+    memcpy(ret->need_rescan, src->need_rescan, words);
+
     for (int i = 0; i < 4 * src->size; i ++) {
-        ret->need_update[i] = src->need_update[i];
-        ret->need_handle[i] = src->need_handle[i];
         street_copy(&ret->streets[i], &src->streets[i]);
     }
 
     return ret;
 }
 
+/** Сохраняет строку @p y в подключённый снимок перед первым изменением. */
+static void
+snapshot_row(city_t *city, int y)
+{
+    snapshot_t *snapshot = city->snapshot;
+
+    if (snapshot == NULL || bits_test(snapshot->saved_rows, y)) {
+        return;
+    }
+
+    bits_set(snapshot->saved_rows, y);
+
+    for (int i = y * city->size; i < (y + 1) * city->size; i++) {
+        snapshot->towers[i].options = city->towers[i].options;
+        snapshot->towers[i].height = city->towers[i].height;
+    }
+}
+
+/** Сохраняет улицу @p i и её изменения в подключённый снимок перед первым изменением. */
+static void
+snapshot_street(city_t *city, int i)
+{
+    snapshot_t *snapshot = city->snapshot;
+
+    if (snapshot == NULL || bits_test(snapshot->saved_streets, i)) {
+        return;
+    }
+
+    int sz = city->size;
+    bits_set(snapshot->saved_streets, i);
+    street_copy(&snapshot->streets[i], &city->streets[i]);
+    memcpy(&snapshot->removed[i * sz], &city->removed[i * sz], (size_t) sz * sizeof(unsigned int));
+    snapshot->fixed[i] = city->fixed[i];
+}
+
+static void
+mark_street(city_t *city, int i)
+{
+    snapshot_street(city, i);
+    city->outdated += !bits_test(city->need_update, i);
+    bits_set(city->need_update, i);
+    bits_set(city->need_handle, i);
+}
+
 void
 city_notify_of_tower_change(city_t *city, int x, int y)
 {
@@ -123,21 +248,13 @@ city_notify_of_tower_change(city_t *city, int x, int y)
     assert(x >= 0 && x < sz);
     assert(y >= 0 && y < sz);
     /* Side::TOP */
-    int i = x;
-    city->need_update[i] = true;
-    city->need_handle[i] = true;
+    mark_street(city, x);
     /* Side::RIGHT */
-    i = sz + y;
-    city->need_update[i] = true;
-    city->need_handle[i] = true;
+    mark_street(city, sz + y);
     /* Side::BOTTOM */
-    i = 3 * sz - x - 1;
-    city->need_update[i] = true;
-    city->need_handle[i] = true;
+    mark_street(city, 3 * sz - x - 1);
     /* Side::LEFT */
-    i = 4 * sz - y - 1;
-    city->need_update[i] = true;
-    city->need_handle[i] = true;
+    mark_street(city, 4 * sz - y - 1);
 }
 
 void
@@ -147,81 +264,359 @@ city_notify_of_street_change(city_t *city, int side, int pos)
     assert(side >= 0 && side < 4);
     assert(pos >= 0 && pos < city->size);
     int i = side * city->size + pos;
-    city->need_update[i] = true;
-    city->need_handle[i] = true;
+    mark_street(city, i);
+    bits_set(city->need_rescan, i);
+}
+
+void
+city_notify_of_options_change(city_t *city, int x, int y, int changed)
+{
+    assert(city != NULL);
+    int sz = city->size;
+
+    for (unsigned int rest = (unsigned int) changed; rest != 0; rest &= rest - 1) {
+        int h = bits_lowest(rest);
+        city->rows[h * sz + y] ^= 1u << x;
+        city->cols[h * sz + x] ^= 1u << y;
+    }
+
+    unsigned int options = (unsigned int) city->towers[x + y * sz].options;
+    /* Улицы через здание и его номер на каждой из них. */
+    int streets[4] = {x, sz + y, 3 * sz - x - 1, 4 * sz - y - 1};
+    int indexes[4] = {y, sz - 1 - x, sz - 1 - y, x};
 
+    for (int j = 0; j < 4; j++) {
+        /* Вернувшиеся этажи, например при откате по следу, делают изменения неизвестными. */
+        if (((unsigned int) changed & options) != 0) {
+            bits_set(city->need_rescan, streets[j]);
+            continue;
+        }
+
+        snapshot_street(city, streets[j]);
+        city->removed[streets[j] * sz + indexes[j]] |= (unsigned int) changed;
+
+        if (bits_is_single(options)) {
+            city->fixed[streets[j]] |= 1u << indexes[j];
+        }
+    }
 }
 
-static void
-load_clues(city_t *city, const int *clues, bool constraint)
+void
+city_clear_delta(city_t *city, int index)
 {
-    for (int i = 0; i < 4 * city->size; i++) {
-        street_t *street = &city->streets[i];
-        int clue = clues[i];
-        street_set_clue(street, clue);
+    assert(city != NULL);
+    int sz = city->size;
+    snapshot_street(city, index);
+    memset(&city->removed[index * sz], 0, (size_t) sz * sizeof(unsigned int));
+    city->fixed[index] = 0;
+    bits_reset(city->need_rescan, index);
+}
+
+void
+city_count_tower(city_t *city, const tower_t *tower, int delta)
+{
+    city->unsolved += tower->height == 0 ? delta : 0;
+    city->empty += tower->options == 0 ? delta : 0;
+}
+
+bool
+city_update_street(city_t *city, int index)
+{
+    assert(city != NULL);
+    street_t *street = &city->streets[index];
+
+    if (bits_test(city->need_update, index)) {
+        snapshot_street(city, index);
+        city->invalid -= !street->valid;
+        street_update(street);
+        city->invalid += !street->valid;
+        bits_reset(city->need_update, index);
+        city->outdated--;
+    }
+
+    return street->valid;
+}
+
+void
+city_sync_towers(city_t *city)
+{
+    assert(city != NULL);
+    int sz = city->size;
+    memset(city->rows, 0, (size_t) (sz * sz) * sizeof(unsigned int));
+    memset(city->cols, 0, (size_t) (sz * sz) * sizeof(unsigned int));
+
+    city->unsolved = 0;
+    city->empty = 0;
 
-        if (constraint) {
-            street_fast_constraint(street);
+    for (int y = 0; y < sz; y++) {
+        for (int x = 0; x < sz; x++) {
+            const tower_t *tower = &city->towers[x + y * sz];
+            city_notify_of_options_change(city, x, y, tower->options);
+            city_count_tower(city, tower, 1);
         }
     }
 }
 
 void
-city_load_clues(city_t *city, const int *clues)
+city_trail_free(city_t *city, trail_t *trail)
 {
     assert(city != NULL);
-    assert(clues != NULL);
-    load_clues(city, clues, true);
+    assert(trail != NULL);
+    memory_free(&city->memory, trail->entries, (size_t) trail->capacity * sizeof(trail_entry_t));
+    trail->entries = NULL;
+    trail->size = 0;
+    trail->capacity = 0;
 }
 
 void
-city_set_clues(city_t *city, const int *clues)
+city_trail_save(city_t *city, const tower_t *tower)
 {
     assert(city != NULL);
-    assert(clues != NULL);
-    load_clues(city, clues, false);
+    trail_t *trail = city->trail;
+    snapshot_row(city, tower->y);
+
+    if (trail == NULL) {
+        return;
+    }
+
+    if (trail->size == trail->capacity) {
+        size_t old_size = (size_t) trail->capacity * sizeof(trail_entry_t);
+        trail->capacity = trail->capacity == 0 ? 256 : 2 * trail->capacity;
+        trail->entries = memory_grow(&city->memory, trail->entries, old_size,
+                                     (size_t) trail->capacity * sizeof(trail_entry_t));
+    }
+
+    trail_entry_t *entry = &trail->entries[trail->size++];
+    entry->tower = tower->x + tower->y * city->size;
+    entry->options = tower->options;
+    entry->height = tower->height;
 }
 
+void
+city_trail_restore(city_t *city, const trail_t *trail, int mark)
+{
+    assert(city != NULL);
+    assert(trail != NULL);
+    assert(mark >= 0 && mark <= trail->size);
+
+    for (int i = trail->size - 1; i >= mark; i--) {
+        const trail_entry_t *entry = &trail->entries[i];
+        tower_t *tower = &city->towers[entry->tower];
+        int changed = tower->options ^ entry->options;
+        snapshot_row(city, tower->y);
+        city_count_tower(city, tower, -1);
+        tower->options = entry->options;
+        tower->height = entry->height;
+        city_count_tower(city, tower, 1);
+
+        if (changed != 0) {
+            city_notify_of_options_change(city, tower->x, tower->y, changed);
+        }
+
+        city_notify_of_tower_change(city, tower->x, tower->y);
+    }
+}
+
+snapshot_t *
+city_snapshot_new(city_t *city)
+{
+    assert(city != NULL);
+    int sz = city->size;
+    size_t words = (size_t) BITS_WORDS(4 * sz);
+    memory_t *memory = &city->memory;
+    snapshot_t *ret = memory_alloc(memory, sizeof(snapshot_t));
+    ret->size = sz;
+    ret->memory = memory;
+    ret->towers = memory_alloc(memory, (size_t) (sz * sz) * sizeof(trail_entry_t));
+    ret->streets = memory_alloc(memory, (size_t) (4 * sz) * sizeof(street_t));
+    ret->removed = memory_alloc(memory, (size_t) (4 * sz * sz) * sizeof(unsigned int));
+    ret->fixed = memory_alloc(memory, (size_t) (4 * sz) * sizeof(unsigned int));
+    ret->saved_rows = memory_calloc(memory, (size_t) BITS_WORDS(sz), sizeof(unsigned long));
+    ret->saved_streets = memory_calloc(memory, words, sizeof(unsigned long));
+    ret->need_update = memory_calloc(memory, words, sizeof(unsigned long));
+    ret->need_handle = memory_calloc(memory, words, sizeof(unsigned long));
+    ret->need_rescan = memory_calloc(memory, words, sizeof(unsigned long));
+
+    for (int i = 0; i < sz * sz; i++) {
+        ret->towers[i].tower = i;
+    }
+
+    for (int i = 0; i < 4 * sz; i++) {
+        street_make(&ret->streets[i], city, i / sz, i % sz);
+    }
+
+    return ret;
+}
+
+void
+city_snapshot_free(snapshot_t *snapshot)
+{
+    assert(snapshot != NULL);
+
+    for (int i = 0; i < 4 * snapshot->size; i++) {
+        street_free(&snapshot->streets[i]);
+    }
+
+    memory_t *memory = snapshot->memory;
+    size_t sz = (size_t) snapshot->size;
+    size_t words = (size_t) BITS_WORDS(4 * snapshot->size) * sizeof(unsigned long);
+    memory_free(memory, snapshot->towers, sz * sz * sizeof(trail_entry_t));
+    memory_free(memory, snapshot->streets, 4 * sz * sizeof(street_t));
+    memory_free(memory, snapshot->removed, 4 * sz * sz * sizeof(unsigned int));
+    memory_free(memory, snapshot->fixed, 4 * sz * sizeof(unsigned int));
+    memory_free(memory, snapshot->saved_rows,
+                (size_t) BITS_WORDS(snapshot->size) * sizeof(unsigned long));
+    memory_free(memory, snapshot->saved_streets, words);
+    memory_free(memory, snapshot->need_update, words);
+    memory_free(memory, snapshot->need_handle, words);
+    memory_free(memory, snapshot->need_rescan, words);
+    memory_free(memory, snapshot, sizeof(snapshot_t));
+}
+
+void
+city_snapshot_take(city_t *city, snapshot_t *snapshot)
+{
+    assert(city != NULL);
+    assert(snapshot != NULL);
+    assert(snapshot->size == city->size);
+    size_t words = (size_t) BITS_WORDS(4 * city->size) * sizeof(unsigned long);
+    city->snapshot = snapshot;
+    memset(snapshot->saved_rows, 0, (size_t) BITS_WORDS(city->size) * sizeof(unsigned long));
+    memset(snapshot->saved_streets, 0, words);
+    memcpy(snapshot->need_update, city->need_update, words);
+    memcpy(snapshot->need_handle, city->need_handle, words);
+    memcpy(snapshot->need_rescan, city->need_rescan, words);
+    snapshot->unsolved = city->unsolved;
+    snapshot->empty = city->empty;
+    snapshot->invalid = city->invalid;
+    snapshot->outdated = city->outdated;
+}
+
+void
+city_snapshot_restore(city_t *city)
+{
+    assert(city != NULL);
+    snapshot_t *snapshot = city->snapshot;
+    assert(snapshot != NULL);
+    int sz = city->size;
+
+    for (int y = bits_next(snapshot->saved_rows, sz, 0); y >= 0;
+            y = bits_next(snapshot->saved_rows, sz, y + 1)) {
+        for (int x = 0; x < sz; x++) {
+            tower_t *tower = &city->towers[x + y * sz];
+            const trail_entry_t *entry = &snapshot->towers[x + y * sz];
+
+            /* Доски обновляются без изменений улиц, улицы возвращаются целиком ниже. */
+            for (unsigned int rest = (unsigned int) (tower->options ^ entry->options); rest != 0;
+                    rest &= rest - 1) {
+                int h = bits_lowest(rest);
+                city->rows[h * sz + y] ^= 1u << x;
+                city->cols[h * sz + x] ^= 1u << y;
+            }
+
+            tower->options = entry->options;
+            tower->height = entry->height;
+        }
+    }
+
+    for (int i = bits_next(snapshot->saved_streets, 4 * sz, 0); i >= 0;
+            i = bits_next(snapshot->saved_streets, 4 * sz, i + 1)) {
+        street_copy(&city->streets[i], &snapshot->streets[i]);
+        memcpy(&city->removed[i * sz], &snapshot->removed[i * sz], (size_t) sz * sizeof(unsigned int));
+        city->fixed[i] = snapshot->fixed[i];
+    }
+
+    size_t words = (size_t) BITS_WORDS(4 * sz) * sizeof(unsigned long);
+    memcpy(city->need_update, snapshot->need_update, words);
+    memcpy(city->need_handle, snapshot->need_handle, words);
+    memcpy(city->need_rescan, snapshot->need_rescan, words);
+    city->unsolved = snapshot->unsolved;
+    city->empty = snapshot->empty;
+    city->invalid = snapshot->invalid;
+    city->outdated = snapshot->outdated;
+    city_snapshot_take(city, snapshot);
+}
+
+static void
+load_clues(city_t *city, const int *clues)
+{
+    for (int i = 0; i < 4 * city->size; i++) {
+        street_set_clue(&city->streets[i], clues[i]);
+    }
+}
+
+/**
+ * Загружает подсказки и накладывает начальные ограничения совместно для каждой пары
+ * противоположных подсказок. Несовместимый набор подсказок отвергается до начала решения.
+ *
+ * @param [in] city Головоломка.
+ * @param [in] clues Подсказки, 4 * city_t::size элементов по часовой стрелке начиная с верхней
+ * стороны.
+ * @return false если подсказки несовместимы, город при этом становится ошибочным.
+ */
 bool
-city_is_valid(const city_t *city)
+city_load_clues(city_t *city, const int *clues)
 {
     assert(city != NULL);
+    assert(clues != NULL);
+    load_clues(city, clues);
     bool valid = true;
+    int size = city->size;
 
-    for (int i = 0; i < 4 * city->size; i ++) {
+    /* Верхние улицы в паре с нижними и правые с левыми. */
+    for (int i = 0; i < 2 * size; i++) {
         street_t *street = &city->streets[i];
+        street_t *opposite = &city->streets[(street->side + 2) * size + size - 1 - street->pos];
 
-        if (city->need_update[i]) {
-            street_update(street);
-            city->need_update[i] = false;
-        }
-
-        if (!street->valid) {
+        if (!street_joint_constraint(street, opposite)) {
             valid = false;
         }
     }
 
-    return  valid;
+    return valid;
+}
+
+void
+city_prepare_tables(int max_size)
+{
+    assert(max_size <= CITY_MAX_SIZE);
+
+    for (int size = CITY_MIN_SIZE; size <= max_size; size++) {
+        clue_table_get(size);
+    }
+}
+
+void
+city_set_clues(city_t *city, const int *clues)
+{
+    assert(city != NULL);
+    assert(clues != NULL);
+    load_clues(city, clues);
 }
 
 bool
-city_is_solved(const city_t *city)
+city_is_valid(city_t *city)
 {
     assert(city != NULL);
 
-    if (!city_is_valid(city)) {
+    if (city->empty != 0) {
         return false;
     }
 
-    for (int x = 0; x < city->size; x++) {
-        for (int y = 0; y < city->size; y++) {
-            if (city_get_tower(city, 0, x, y)->height == 0) {
-                return false;
-            }
-        }
+    for (int i = bits_next(city->need_update, 4 * city->size, 0); i >= 0;
+            i = bits_next(city->need_update, 4 * city->size, i + 1)) {
+        city_update_street(city, i);
     }
 
-    return true;
+    return city->invalid == 0;
+}
+
+bool
+city_is_solved(city_t *city)
+{
+    assert(city != NULL);
+
+    return city->unsolved == 0 && city_is_valid(city);
 }
 
 static int
@@ -374,19 +769,8 @@ city_calc_iteration(const city_t *city)
             tower_t *tower = city_get_tower(city, 0, x, y);
 
             if (tower->height == 0) {
-                unsigned int v = 0;
-                int m = 1;
-
-                for (int h = 0; h < city->size; h++) {
-                    if ((tower->options & m) != 0) {
-                        v++;
-                    }
-
-                    m <<= 1;
-                }
-
                 i++;
-                result *= v;
+                result *= (unsigned int) bits_count((unsigned int) tower->options);
             }
         }
     }
@@ -396,6 +780,50 @@ city_calc_iteration(const city_t *city)
     return result * 2 / i / 3;
 }
 
+void
+city_set_log(city_t *city, FILE *log)
+{
+    assert(city != NULL);
+    city->log = log;
+}
+
+void
+city_set_methods(city_t *city, unsigned int methods)
+{
+    assert(city != NULL);
+
+    /* Новые методы ещё не видели улиц, изменения которых уже забыты. */
+    if ((methods & ~city->methods) != 0) {
+        for (int i = 0; i < 4 * city->size; i++) {
+            bits_set(city->need_rescan, i);
+        }
+    }
+
+    city->methods = methods;
+}
+
+unsigned int
+city_get_methods(const city_t *city)
+{
+    assert(city != NULL);
+    return city->methods;
+}
+
+void
+city_set_value_order(city_t *city, int order)
+{
+    assert(city != NULL);
+    assert(order >= 0 && order < ORDER_COUNT);
+    city->value_order = order;
+}
+
+int
+city_get_value_order(const city_t *city)
+{
+    assert(city != NULL);
+    return city->value_order;
+}
+
 void
 city_print(const city_t *city)
 {
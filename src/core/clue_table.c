@@ -0,0 +1,216 @@
+/* utf-8 */
+
+/**
+ * @file
+ * @brief Таблицы ограничений для пары противоположных подсказок.
+ * @details Таблица размера N строится перебором N! перестановок алгоритмом Хипа. Для каждой
+ * перестановки считается видимость с обоих краёв, и высоты перестановки добавляются в четыре
+ * записи: с обеими подсказками, только с ближней, только с дальней и без подсказок.
+ *
+ * @date создан 19.10.2026
+ * @author Nick Egorrov
+ * @copyright http://www.apache.org/licenses/LICENSE-2.0
+ */
+
+#include <assert.h>
+#include <stdlib.h>
+#include "skyskrapers/clue_table.h"
+
+/* Таблица публикуется атомарно: если два потока строят её одновременно, то побеждает первый,
+ * а второй удаляет свою копию. Без атомарных встроенных функций таблицы нужно построить
+ * заранее вызовом city_prepare_tables(). */
+#if defined(__GNUC__)
+#define LOAD_ACQUIRE(ptr) __atomic_load_n(ptr, __ATOMIC_ACQUIRE)
+#define PUBLISH(ptr, expected, value) \
+    __atomic_compare_exchange_n(ptr, expected, value, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)
+#else
+#define LOAD_ACQUIRE(ptr) (*(ptr))
+#define PUBLISH(ptr, expected, value) (*(ptr) = (value), true)
+#endif
+
+static clue_table_t *tables[CLUE_TABLE_MAX_SIZE + 1];
+
+static void
+table_add(clue_table_t *table, const int *heights)
+{
+    int size = table->size;
+    int near = 0, far = 0, highest = 0, top = 0;
+
+    for (int k = 0; k < size; k++) {
+        if (heights[k] > top) {
+            top = heights[k];
+            highest = k;
+            near++;
+        }
+    }
+
+    top = 0;
+
+    for (int k = size - 1; k >= 0; k--) {
+        if (heights[k] > top) {
+            top = heights[k];
+            far++;
+        }
+    }
+
+    int pairs[4][2] = {{near, far}, {0, far}, {near, 0}, {0, 0}};
+
+    for (int i = 0; i < 4; i++) {
+        int index = pairs[i][0] * (size + 1) + pairs[i][1];
+        table->tallest[index] |= 1 << highest;
+
+        for (int k = 0; k < size; k++) {
+            table->allowed[index * size + k] |= 1 << (heights[k] - 1);
+        }
+    }
+}
+
+static clue_table_t *
+table_build(int size)
+{
+    size_t entries = (size_t) (size + 1) * (size_t) (size + 1);
+    clue_table_t *ret = malloc(sizeof(clue_table_t));
+    int heights[CLUE_TABLE_MAX_SIZE];
+    int counters[CLUE_TABLE_MAX_SIZE];
+    assert(ret != NULL);
+    ret->size = size;
+    ret->allowed = calloc(entries * (size_t) size, sizeof(int));
+    ret->tallest = calloc(entries, sizeof(int));
+    assert(ret->allowed != NULL && ret->tallest != NULL);
+
+    for (int k = 0; k < size; k++) {
+        heights[k] = k + 1;
+        counters[k] = 0;
+    }
+
+    table_add(ret, heights);
+
+    for (int i = 1; i < size;) {
+        if (counters[i] < i) {
+            int j = i % 2 == 0 ? 0 : counters[i];
+            int tmp = heights[j];
+            heights[j] = heights[i];
+            heights[i] = tmp;
+            table_add(ret, heights);
+            counters[i]++;
+            i = 1;
+        } else {
+            counters[i] = 0;
+            i++;
+        }
+    }
+
+    return ret;
+}
+
+const clue_table_t *
+clue_table_get(int size)
+{
+    if (size < 1 || size > CLUE_TABLE_MAX_SIZE) {
+        return NULL;
+    }
+
+    clue_table_t *table = LOAD_ACQUIRE(&tables[size]);
+
+    if (table != NULL) {
+        return table;
+    }
+
+    clue_table_t *expected = NULL;
+    table = table_build(size);
+
+    if (!PUBLISH(&tables[size], &expected, table)) {
+        free(table->allowed);
+        free(table->tallest);
+        free(table);
+        table = expected;
+    }
+
+    return table;
+}
+
+/**
+ * Аналитические границы для рядов без таблицы. Самое высокое здание стоит не ближе
+ * near - 1 к ближнему краю и не ближе far - 1 к дальнему, а здание в позиции k не выше
+ * size - near + 1 + k, иначе перед ним не поместятся видимые здания.
+ */
+static bool
+bound_masks(int size, int near, int far, int *masks)
+{
+    int first = near > 0 ? near - 1 : 0;
+    int last = far > 0 ? size - far : size - 1;
+
+    if (near == 1) {
+        last = last < 0 ? last : 0;
+    }
+
+    if (far == 1) {
+        first = first > size - 1 ? first : size - 1;
+    }
+
+    if (first > last) {
+        return false;
+    }
+
+    for (int k = 0; k < size; k++) {
+        int top = size;
+        int top_near = size - near + 1 + k;
+        int top_far = size - far + 1 + (size - 1 - k);
+
+        if (near > 0 && top_near < top) {
+            top = top_near;
+        }
+
+        if (far > 0 && top_far < top) {
+            top = top_far;
+        }
+
+        masks[k] = (1 << top) - 1;
+
+        if (k < first || k > last) {
+            masks[k] &= ~(1 << (size - 1));
+        } else if (first == last) {
+            masks[k] = 1 << (size - 1);
+        }
+
+        if (near == size) {
+            masks[k] &= 1 << k;
+        }
+
+        if (far == size) {
+            masks[k] &= 1 << (size - 1 - k);
+        }
+
+        if (masks[k] == 0) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool
+clue_table_masks(int size, int near, int far, int *masks)
+{
+    assert(size > 0);
+    assert(near >= 0 && near <= size);
+    assert(far >= 0 && far <= size);
+    assert(masks != NULL);
+    const clue_table_t *table = clue_table_get(size);
+
+    if (table == NULL) {
+        return bound_masks(size, near, far, masks);
+    }
+
+    int index = near * (size + 1) + far;
+
+    if (table->tallest[index] == 0) {
+        return false;
+    }
+
+    for (int k = 0; k < size; k++) {
+        masks[k] = table->allowed[index * size + k];
+    }
+
+    return true;
+}
@@ -0,0 +1,102 @@
+/* utf-8 */
+
+/**
+ * @file
+ * @brief Память головоломки.
+ * @details Обёртка над распределителем, которая ведёт статистику: каждое выделение и
+ * освобождение меняет занятые байты, наибольшее их значение и счётчики вызовов.
+ * Размер блока передаётся при освобождении, поэтому блоки не хранят заголовков и
+ * распределитель может быть простой ареной. Если распределитель не задан, используются
+ * malloc() и free(). memory_grow() заменяет realloc(), которого у распределителя нет.
+ *
+ * @date создан 19.10.2026
+ * @author Nick Egorrov
+ * @copyright http://www.apache.org/licenses/LICENSE-2.0
+ */
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include "skyskrapers/memory.h"
+
+static void *
+default_alloc(void *context, size_t size)
+{
+    (void) context;
+    return malloc(size);
+}
+
+static void
+default_release(void *context, void *ptr, size_t size)
+{
+    (void) context;
+    (void) size;
+    free(ptr);
+}
+
+void
+memory_init(memory_t *memory, const allocator_t *allocator)
+{
+    assert(memory != NULL);
+
+    if (allocator != NULL) {
+        assert(allocator->alloc != NULL && allocator->release != NULL);
+        memory->allocator = *allocator;
+    } else {
+        memory->allocator.alloc = default_alloc;
+        memory->allocator.release = default_release;
+        memory->allocator.context = NULL;
+    }
+
+    memset(&memory->stats, 0, sizeof(memory_stats_t));
+}
+
+void *
+memory_alloc(memory_t *memory, size_t size)
+{
+    void *ret = memory->allocator.alloc(memory->allocator.context, size);
+    assert(ret != NULL);
+    memory_stats_t *stats = &memory->stats;
+    stats->allocs++;
+    stats->current += size;
+
+    if (stats->current > stats->peak) {
+        stats->peak = stats->current;
+    }
+
+    return ret;
+}
+
+void *
+memory_calloc(memory_t *memory, size_t count, size_t size)
+{
+    void *ret = memory_alloc(memory, count * size);
+    memset(ret, 0, count * size);
+    return ret;
+}
+
+void *
+memory_grow(memory_t *memory, void *ptr, size_t old_size, size_t size)
+{
+    assert(size >= old_size);
+    void *ret = memory_alloc(memory, size);
+
+    if (ptr != NULL) {
+        memcpy(ret, ptr, old_size);
+        memory_free(memory, ptr, old_size);
+    }
+
+    return ret;
+}
+
+void
+memory_free(memory_t *memory, void *ptr, size_t size)
+{
+    if (ptr == NULL) {
+        return;
+    }
+
+    memory->allocator.release(memory->allocator.context, ptr, size);
+    memory->stats.frees++;
+    memory->stats.current -= size;
+}
@@ -0,0 +1,583 @@
+/* utf-8 */
+
+/**
+ * @file
+ * @brief Пошаговый поиск решения.
+ * @details Поиск - это конечный автомат. В состоянии SEARCH_PROPAGATE каждый шаг выполняет
+ * один цикл эвристик. Когда эвристики ничего не дают, один шаг выполняет пробы высот
+ * method_probe(). Когда и пробы ничего не дают, автомат переходит в SEARCH_BRANCH и
+ * заводит точку выбора с длиной следа изменений. В состоянии SEARCH_NEXT город откатывается
+ * по следу к верхней точке и зданию назначается следующая высота, начиная с самой большой.
+ * Если высоты точки закончились, она снимается со стека.
+ *
+ * Точка выбора заводится только на неподвижной точке эвристик, поэтому после отката ряды
+ * обрабатывать не нужно, достаточно обновить их состояние.
+ *
+ * @date создан 19.10.2026
+ * @author Nick Egorrov
+ * @copyright http://www.apache.org/licenses/LICENSE-2.0
+ */
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include "skyskrapers/skyskrapers.h"
+#include "skyskrapers/city.h"
+#include "skyskrapers/street.h"
+#include "skyskrapers/tower.h"
+#include "skyskrapers/methods.h"
+#include "skyskrapers/search.h"
+#include "skyskrapers/bits.h"
+
+search_t *
+search_new(city_t *city)
+{
+    search_t *ret = memory_alloc(&city->memory, sizeof(search_t));
+    ret->state = SEARCH_PROPAGATE;
+    ret->status = SOLVE_RUNNING;
+    ret->depth = 0;
+    ret->capacity = 0;
+    ret->stack = NULL;
+    ret->trail.entries = NULL;
+    ret->trail.size = 0;
+    ret->trail.capacity = 0;
+    ret->nogoods = NULL;
+    ret->nogood_count = 0;
+    ret->nogood_next = 0;
+    return ret;
+}
+
+void
+search_free(city_t *city, search_t *search)
+{
+    assert(search != NULL);
+    memory_t *memory = &city->memory;
+    memory_free(memory, search->stack, (size_t) search->capacity * sizeof(choice_t));
+    city_trail_free(city, &search->trail);
+    memory_free(memory, search->nogoods, NOGOOD_CAPACITY * sizeof(nogood_t));
+
+    memory_free(memory, search, sizeof(search_t));
+}
+
+static choice_t *
+search_push(city_t *city, search_t *search)
+{
+    if (search->depth == search->capacity) {
+        size_t old_size = (size_t) search->capacity * sizeof(choice_t);
+        search->capacity = search->capacity == 0 ? 16 : 2 * search->capacity;
+        search->stack = memory_grow(&city->memory, search->stack, old_size,
+                                    (size_t) search->capacity * sizeof(choice_t));
+    }
+
+    city->trail = &search->trail;
+    choice_t *choice = &search->stack[search->depth++];
+    choice->mark = search->trail.size;
+    return choice;
+}
+
+static void
+search_pop(city_t *city, search_t *search)
+{
+    assert(search->depth > 0);
+    search->depth--;
+
+    if (search->depth == 0) {
+        city->trail = NULL;
+        search->trail.size = 0;
+    }
+}
+
+/**
+ * Откатывает город по следу к неподвижной точке эвристик с длиной следа @p mark.
+ */
+static void
+search_restore(city_t *city, const search_t *search, int mark)
+{
+    city_trail_restore(city, &search->trail, mark);
+    size_t words = (size_t) BITS_WORDS(4 * city->size) * sizeof(unsigned long);
+    memset(city->need_handle, 0, words);
+    /* Точка выбора была неподвижной точкой эвристик, изменения до неё уже учтены. */
+    memset(city->need_rescan, 0, words);
+    memset(city->removed, 0, (size_t) (4 * city->size * city->size) * sizeof(unsigned int));
+    memset(city->fixed, 0, (size_t) (4 * city->size) * sizeof(unsigned int));
+}
+
+static void
+search_finish(city_t *city, search_t *search, solve_status_t status)
+{
+    /* Стек остаётся для city_search_save(), но изменения больше не записываются. */
+    city->trail = NULL;
+    search->state = SEARCH_DONE;
+    search->status = status;
+}
+
+/** Прерывание по ограничениям: город возвращается в состояние до первой точки выбора. */
+static void
+search_abort(city_t *city, search_t *search)
+{
+    if (search->depth > 0) {
+        search_restore(city, search, search->stack[0].mark);
+    }
+
+    while (search->depth > 0) {
+        search_pop(city, search);
+    }
+
+    search_finish(city, search, SOLVE_TIMEOUT);
+}
+
+/**
+ * Повторяет решения сочетания @p nogood на копии города до первой точки выбора.
+ *
+ * @return true если копия стала ошибочной.
+ */
+static bool
+search_replay(city_t *replay, const city_t *city, const search_t *search, const nogood_t *nogood)
+{
+    city_copy(replay, city);
+    search_restore(replay, search, search->stack[0].mark);
+    replay->methods &= ~(unsigned int) METHOD_PROBE;
+    replay->log = NULL;
+    replay->control = NULL;
+    replay->street_cache = NULL;
+
+    for (int i = 0; i < nogood->size; i++) {
+        tower_set_height(&replay->towers[nogood->tower[i]], nogood->height[i]);
+    }
+
+    while (city_is_valid(replay) && !city_is_solved(replay)) {
+        if (!city_solve_step(replay)) {
+            return false;
+        }
+    }
+
+    return !city_is_valid(replay);
+}
+
+/**
+ * Собирает в @p nogood решения точек выбора. Если @p lines не ноль, берутся только решения,
+ * здания которых стоят в ошибочных рядах: на улицах, нарушивших подсказку, и в строке и
+ * столбце здания без этажей. Последнее решение берётся всегда: без него город был верным.
+ *
+ * @return false если решений больше NOGOOD_MAX.
+ */
+static bool
+search_explain(const city_t *city, const search_t *search, bool lines, nogood_t *nogood)
+{
+    unsigned int rows = 0, cols = 0;
+
+    for (int i = 0; lines && i < 4 * city->size; i++) {
+        const street_t *street = &city->streets[i];
+
+        if (street->valid) {
+            continue;
+        } else if (street->side == TOP || street->side == BOTTOM) {
+            cols |= 1u << street_get_tower(street, 0)->x;
+        } else {
+            rows |= 1u << street_get_tower(street, 0)->y;
+        }
+    }
+
+    for (int i = 0; lines && city->empty != 0 && i < city->size * city->size; i++) {
+        if (city->towers[i].options == 0) {
+            rows |= 1u << city->towers[i].y;
+            cols |= 1u << city->towers[i].x;
+        }
+    }
+
+    nogood->size = 0;
+
+    for (int d = 0; d < search->depth; d++) {
+        const choice_t *choice = &search->stack[d];
+        const tower_t *tower = &city->towers[choice->tower];
+
+        if (lines && d < search->depth - 1 && (rows & (1u << tower->y)) == 0
+                && (cols & (1u << tower->x)) == 0) {
+            continue;
+        }
+
+        if (nogood->size == NOGOOD_MAX) {
+            return false;
+        }
+
+        nogood->tower[nogood->size] = choice->tower;
+        nogood->height[nogood->size] = choice->height;
+        nogood->size++;
+    }
+
+    return true;
+}
+
+/**
+ * Запоминает решения точек выбора, которые привели к ошибке. Сначала берутся решения в
+ * ошибочных рядах, и одно повторное решение с первой точки выбора проверяет, что их
+ * достаточно. Если нет, запоминаются все решения.
+ */
+static void
+search_learn(city_t *city, search_t *search)
+{
+    int depth = search->depth;
+    nogood_t nogood;
+
+    if (depth == 0) {
+        return;
+    }
+
+    /* После загрузки сохранённого поиска проверяемые высоты неизвестны. */
+    for (int d = 0; d < depth; d++) {
+        if (search->stack[d].height == 0) {
+            return;
+        }
+    }
+
+    if (!search_explain(city, search, true, &nogood)) {
+        return;
+    }
+
+    if (nogood.size < depth) {
+        city_t *replay = city_copy(0, city);
+        bool failed = search_replay(replay, city, search, &nogood);
+        city_free(replay);
+
+        if (!failed && !search_explain(city, search, false, &nogood)) {
+            return;
+        }
+    }
+
+    if (search->nogoods == NULL) {
+        search->nogoods = memory_alloc(&city->memory, NOGOOD_CAPACITY * sizeof(nogood_t));
+    }
+
+    search->nogoods[search->nogood_next] = nogood;
+    search->nogood_next = (search->nogood_next + 1) % NOGOOD_CAPACITY;
+    search->nogood_count += search->nogood_count < NOGOOD_CAPACITY;
+}
+
+void
+search_step(city_t *city)
+{
+    search_t *search = city->search;
+    assert(search != NULL);
+
+    switch (search->state) {
+    case SEARCH_PROPAGATE:
+        if (city_is_solved(city)) {
+            search_finish(city, search, SOLVE_SOLVED);
+        } else if (!city_is_valid(city)) {
+            city_log(city, "ERROR\nInvalid city.\n");
+
+            if ((city->methods & METHOD_NOGOOD) != 0) {
+                search_learn(city, search);
+            }
+
+            search->state = SEARCH_NEXT;
+        } else if (city_check_budget(city, false)) {
+            search_abort(city, search);
+        } else if (city_solve_step(city)) {
+            break;
+        } else if ((city->methods & METHOD_PROBE) != 0 && method_probe(city)) {
+            city_log(city, "Pass probe\n");
+        } else {
+            city_log(city, "Bruteforce.\n");
+            search->state = SEARCH_BRANCH;
+        }
+
+        break;
+
+    case SEARCH_BRANCH: {
+        tower_t *tower = method_bruteforce(city);
+
+        if (tower == NULL) {
+            city_log(city, "ERROR\nNo tower to branch on.\n");
+            search_finish(city, search, SOLVE_ERROR);
+            break;
+        }
+
+        choice_t *choice = search_push(city, search);
+        choice->tower = (int) (tower - city->towers);
+        choice->height = 0;
+        choice->remaining = tower_get_options(tower);
+        search->state = SEARCH_NEXT;
+        break;
+    }
+
+    case SEARCH_NEXT: {
+        if (search->depth == 0) {
+            search_finish(city, search, SOLVE_UNSOLVABLE);
+            break;
+        }
+
+        choice_t *choice = &search->stack[search->depth - 1];
+
+        if (choice->remaining == 0) {
+            search_pop(city, search);
+            break;
+        }
+
+        search_restore(city, search, choice->mark);
+        search->trail.size = choice->mark;
+
+        if (city_check_budget(city, true)) {
+            search_abort(city, search);
+            break;
+        }
+
+        int height = method_order_height(city, choice->tower, choice->remaining);
+        choice->remaining &= ~(1 << (height - 1));
+        choice->height = height;
+        tower_set_height(&city->towers[choice->tower], height);
+        search->state = SEARCH_PROPAGATE;
+        break;
+    }
+
+    default:
+        break;
+    }
+}
+
+/*+************************************
+ *  Сохранение
+ **************************************/
+
+/*
+ * Формат сохранённого поиска, все числа little-endian:
+ *
+ *   4 байта   "SKYS"
+ *   1 байт    версия формата
+ *   1 байт    размер головоломки N
+ *   4N байт   подсказки
+ *   1 байт    состояние автомата
+ *   1 байт    результат для SEARCH_DONE
+ *   2 байта   глубина стека D
+ *   4 байта   длина следа T
+ *   N*N*W     этажи башен текущего состояния, W = (N + 7) / 8 байт на башню
+ *   D раз:
+ *     2 байта   индекс здания перебора
+ *     W байт    непроверенные высоты
+ *     4 байта   длина следа точки выбора
+ *   T раз:
+ *     2 байта   индекс здания
+ *     W байт    этажи здания до изменения
+ *     1 байт    высота здания до изменения
+ *
+ * Состояние улиц и флаги обработки не сохраняются, при загрузке все улицы отмечаются для
+ * обновления.
+ */
+
+#define SAVE_VERSION 2
+
+typedef struct _writer {
+    unsigned char *buf;
+    size_t size;
+    size_t pos;
+} writer_t;
+
+static void
+put(writer_t *w, unsigned int value, int bytes)
+{
+    for (int i = 0; i < bytes; i++) {
+        if (w->pos < w->size) {
+            w->buf[w->pos] = (unsigned char) (value >> (8 * i));
+        }
+
+        w->pos++;
+    }
+}
+
+static void
+put_domains(writer_t *w, const city_t *city, int width)
+{
+    for (int i = 0; i < city->size * city->size; i++) {
+        put(w, (unsigned int) city->towers[i].options, width);
+    }
+}
+
+typedef struct _reader {
+    const unsigned char *buf;
+    size_t size;
+    size_t pos;
+    bool error;
+} reader_t;
+
+static int
+get(reader_t *r, int bytes)
+{
+    unsigned int value = 0;
+
+    if (r->pos + (size_t) bytes > r->size) {
+        r->error = true;
+        return 0;
+    }
+
+    for (int i = 0; i < bytes; i++) {
+        value |= (unsigned int) r->buf[r->pos++] << (8 * i);
+    }
+
+    return (int) value;
+}
+
+/** Загружает этажи башен и отмечает все улицы для обновления. */
+static void
+get_domains(reader_t *r, city_t *city, int width)
+{
+    for (int i = 0; i < city->size * city->size; i++) {
+        tower_t *tower = &city->towers[i];
+        int options = get(r, width);
+
+        if ((options & ~city->mask) != 0) {
+            r->error = true;
+        }
+
+        tower->options = options & city->mask;
+        tower->height = 0;
+
+        for (int h = 1; h <= city->size; h++) {
+            if (tower->options == 1 << (h - 1)) {
+                tower->height = h;
+            }
+        }
+    }
+
+    for (int side = 0; side < 4; side++) {
+        for (int pos = 0; pos < city->size; pos++) {
+            city_notify_of_street_change(city, side, pos);
+        }
+    }
+
+    city_sync_towers(city);
+}
+
+size_t
+city_search_save(const city_t *city, void *buf, size_t size)
+{
+    assert(city != NULL);
+    assert(buf != NULL || size == 0);
+    writer_t w = {buf, size, 0};
+    const search_t *search = city->search;
+    int width = (city->size + 7) / 8;
+
+    put(&w, 'S', 1);
+    put(&w, 'K', 1);
+    put(&w, 'Y', 1);
+    put(&w, 'S', 1);
+    put(&w, SAVE_VERSION, 1);
+    put(&w, (unsigned int) city->size, 1);
+
+    for (int i = 0; i < 4 * city->size; i++) {
+        put(&w, (unsigned int) city->streets[i].clue, 1);
+    }
+
+    put(&w, search ? (unsigned int) search->state : SEARCH_PROPAGATE, 1);
+    put(&w, search ? (unsigned int) search->status : SOLVE_RUNNING, 1);
+    put(&w, search ? (unsigned int) search->depth : 0, 2);
+    put(&w, search ? (unsigned int) search->trail.size : 0, 4);
+    put_domains(&w, city, width);
+
+    for (int i = 0; search && i < search->depth; i++) {
+        put(&w, (unsigned int) search->stack[i].tower, 2);
+        put(&w, (unsigned int) search->stack[i].remaining, width);
+        put(&w, (unsigned int) search->stack[i].mark, 4);
+    }
+
+    for (int i = 0; search && i < search->trail.size; i++) {
+        put(&w, (unsigned int) search->trail.entries[i].tower, 2);
+        put(&w, (unsigned int) search->trail.entries[i].options, width);
+        put(&w, (unsigned int) search->trail.entries[i].height, 1);
+    }
+
+    return w.pos;
+}
+
+city_t *
+city_search_load(const void *buf, size_t size)
+{
+    assert(buf != NULL);
+    reader_t r = {buf, size, 0, false};
+
+    if (get(&r, 1) != 'S' || get(&r, 1) != 'K' || get(&r, 1) != 'Y' || get(&r, 1) != 'S'
+            || get(&r, 1) != SAVE_VERSION) {
+        return NULL;
+    }
+
+    int n = get(&r, 1);
+
+    if (r.error || n < CITY_MIN_SIZE || n > CITY_MAX_SIZE) {
+        return NULL;
+    }
+
+    int width = (n + 7) / 8;
+    city_t *city = city_new(n);
+    int *clues = memory_alloc(&city->memory, 4 * (size_t) n * sizeof(int));
+
+    for (int i = 0; i < 4 * n; i++) {
+        clues[i] = get(&r, 1);
+
+        if (clues[i] > n) {
+            r.error = true;
+            clues[i] = 0;
+        }
+    }
+
+    city_set_clues(city, clues);
+    memory_free(&city->memory, clues, 4 * (size_t) n * sizeof(int));
+
+    search_t *search = search_new(city);
+    city->search = search;
+    search->state = get(&r, 1);
+    search->status = (solve_status_t) get(&r, 1);
+    int depth = get(&r, 2);
+    int trail = get(&r, 4);
+    get_domains(&r, city, width);
+
+    if (search->state < SEARCH_PROPAGATE || search->state > SEARCH_DONE
+            || search->status > SOLVE_ERROR) {
+        r.error = true;
+    }
+
+    for (int i = 0; i < depth && !r.error; i++) {
+        choice_t *choice = search_push(city, search);
+        choice->tower = get(&r, 2);
+        choice->height = 0;
+        choice->remaining = get(&r, width);
+        choice->mark = get(&r, 4);
+
+        if (choice->tower >= n * n || (choice->remaining & ~city->mask) != 0
+                || choice->mark < (i > 0 ? search->stack[i - 1].mark : 0) || choice->mark > trail) {
+            r.error = true;
+        }
+    }
+
+    /* След нужен только при непустом стеке. */
+    if (trail < 0 || (depth == 0 && trail != 0)) {
+        r.error = true;
+    }
+
+    for (int i = 0; i < trail && !r.error; i++) {
+        int index = get(&r, 2);
+
+        if (index >= n * n) {
+            r.error = true;
+            break;
+        }
+
+        city_trail_save(city, &city->towers[index]);
+        trail_entry_t *entry = &search->trail.entries[i];
+        entry->options = get(&r, width);
+        entry->height = get(&r, 1);
+
+        if ((entry->options & ~city->mask) != 0 || entry->height > n) {
+            r.error = true;
+        }
+    }
+
+    if (search->state == SEARCH_DONE) {
+        city->trail = NULL;
+    }
+
+    if (r.error || r.pos != size) {
+        city_free(city);
+        return NULL;
+    }
+
+    return city;
+}
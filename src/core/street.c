@@ -18,6 +18,8 @@
 #include "skyskrapers/city.h"
 #include "skyskrapers/tower.h"
 #include "skyskrapers/street.h"
+#include "skyskrapers/clue_table.h"
+#include "skyskrapers/bits.h"
 
 street_t *
 street_make(street_t *in, city_t *parent, int side, int pos)
@@ -39,7 +41,13 @@ street_make(street_t *in, city_t *parent, int side, int pos)
     ret->visible = 0;
     ret->vacant = 0;
     ret->hill_count = 0;
-    ret->hill_array = malloc((unsigned int) size * sizeof(hill_t));
+    ret->hill_array = memory_alloc(&parent->memory, (size_t) size * sizeof(hill_t));
+    ret->matching = memory_alloc(&parent->memory, (size_t) size * sizeof(int));
+
+    for (int i = 0; i < size; i++) {
+        ret->matching[i] = -1;
+    }
+
     return ret;
 }
 
@@ -55,7 +63,6 @@ street_copy(street_t *dst, const street_t *src)
         return ret;
     }
 
-    ret->parent = src->parent;
     ret->side = src->side;
     ret->pos = src->pos;
     ret->clue = src->clue;
@@ -67,13 +74,16 @@ street_copy(street_t *dst, const street_t *src)
     ret->hill_count = src->hill_count;
     unsigned int sz = (unsigned int) src->size;
     memcpy(ret->hill_array, src->hill_array, sz * sizeof(hill_t));
+    memcpy(ret->matching, src->matching, sz * sizeof(int));
     return ret;
 }
 
 void
 street_free(street_t *street)
 {
-    free(street->hill_array);
+    memory_t *memory = &street->parent->memory;
+    memory_free(memory, street->hill_array, (size_t) street->size * sizeof(hill_t));
+    memory_free(memory, street->matching, (size_t) street->size * sizeof(int));
 }
 
 void
@@ -104,6 +114,113 @@ street_get_tower(const street_t *street, int index)
     return city_get_tower(street->parent, street->side, street->pos, index);
 }
 
+/**
+ * Этажи здания @p index, снятые с последней неподвижной точки эвристик улицы. Если изменения
+ * неизвестны, возвращает все этажи.
+ */
+unsigned int
+street_get_removed(const street_t *street, int index)
+{
+    assert(street != NULL);
+    assert(index >= 0 && index < street->size);
+    const city_t *city = street->parent;
+    int i = (int) (street - city->streets);
+
+    if (bits_test(city->need_rescan, i)) {
+        return (unsigned int) city->mask;
+    }
+
+    return city->removed[i * street->size + index];
+}
+
+/**
+ * Маска зданий улицы, построенных с последней неподвижной точки эвристик улицы. Если
+ * изменения неизвестны, возвращает все здания.
+ */
+unsigned int
+street_get_fixed(const street_t *street)
+{
+    assert(street != NULL);
+    const city_t *city = street->parent;
+    int i = (int) (street - city->streets);
+
+    if (bits_test(city->need_rescan, i)) {
+        return (1u << street->size) - 1u;
+    }
+
+    return city->fixed[i];
+}
+
+/**
+ * Собирает этажи и высоты зданий улицы. Здания улицы лежат в city_t::towers с постоянным
+ * шагом, поэтому сбор - один проход без city_get_tower().
+ */
+void
+street_view_gather(street_view_t *view, const street_t *street)
+{
+    assert(view != NULL);
+    assert(street != NULL);
+    assert(street->size <= STREET_VIEW_MAX_SIZE);
+    int sz = street->size;
+    int pos = street->pos;
+    int first = 0, step = 0;
+
+    switch (street->side) {
+    case TOP:
+        first = pos;
+        step = sz;
+        break;
+
+    case RIGHT:
+        first = pos * sz + sz - 1;
+        step = -1;
+        break;
+
+    case BOTTOM:
+        first = sz * sz - 1 - pos;
+        step = -sz;
+        break;
+
+    default:
+        first = (sz - 1 - pos) * sz;
+        step = 1;
+        break;
+    }
+
+    tower_t *tower = &street->parent->towers[first];
+    view->size = sz;
+
+    for (int i = 0; i < sz; i++, tower += step) {
+        view->towers[i] = tower;
+        view->options[i] = (unsigned int) tower->options;
+        view->gathered[i] = view->options[i];
+        view->heights[i] = tower->height;
+    }
+}
+
+/**
+ * Записывает в здания изменённые этажи.
+ *
+ * @return true если хотя бы одно здание изменилось.
+ */
+bool
+street_view_scatter(street_view_t *view)
+{
+    assert(view != NULL);
+    bool changed = false;
+
+    for (int i = 0; i < view->size; i++) {
+        if (view->options[i] != view->gathered[i]) {
+            tower_set_options(view->towers[i], (int) view->options[i]);
+            view->gathered[i] = view->options[i];
+            view->heights[i] = view->towers[i]->height;
+            changed = true;
+        }
+    }
+
+    return changed;
+}
+
 /**
  * @brief Устанавливает начальные ограничения.
  * @details После загрузки начальной конфигурации при помощи функций city_set_heights()
@@ -152,28 +269,72 @@ street_fast_constraint(street_t *street)
     }
 }
 
+/**
+ * @brief Устанавливает начальные ограничения по паре противоположных подсказок.
+ * @details В отличие от street_fast_constraint() подсказки обоих концов ряда учитываются
+ * совместно, см. clue_table_masks(). Если подсказки несовместимы между собой или с уже
+ * наложенными ограничениями, то у здания не остаётся этажей и город становится ошибочным.
+ *
+ * @param street Ряд.
+ * @param opposite Тот же ряд с противоположной стороны.
+ * @return false если подсказки несовместимы.
+ */
+bool
+street_joint_constraint(street_t *street, street_t *opposite)
+{
+    assert(street != NULL);
+    assert(opposite != NULL);
+    assert(street->size == opposite->size);
+    assert(street->side == (opposite->side + 2) % 4);
+    assert(street->pos == street->size - 1 - opposite->pos);
+    int masks[32];
+    int size = street->size;
+
+    if (!clue_table_masks(size, street->clue, opposite->clue, masks)) {
+        for (int i = 0; i < size; i++) {
+            masks[i] = 0;
+        }
+    }
+
+    bool valid = true;
+
+    for (int i = 0; i < size; i++) {
+        tower_t *tower = street_get_tower(street, i);
+
+        if (!tower_has_floors(tower, masks[i])) {
+            valid = false;
+        }
+
+        tower_and_options(tower, masks[i]);
+    }
+
+    return valid;
+}
+
 /** Получение индекса первого здания с максимальной высотой. */
 static int
-find_highest_first(street_t *street);
+find_highest_first(const street_view_t *view);
 
 /** Получение индекса последнего доступного здания с максимальной высотой. */
 static int
-find_highest_last(street_t *street);
+find_highest_last(const street_view_t *view);
 
 static void
-update_hill(street_t *street);
+update_hill(street_t *street, const street_view_t *view);
 
 static bool
-check_valid(street_t *street);
+check_valid(street_t *street, const street_view_t *view);
 
 bool
 street_update(street_t *street)
 {
     assert(street != NULL);
-    street->highest_first = find_highest_first(street);
-    street->highest_last = find_highest_last(street);
-    update_hill(street);
-    street->valid = check_valid(street);
+    street_view_t view;
+    street_view_gather(&view, street);
+    street->highest_first = find_highest_first(&view);
+    street->highest_last = find_highest_last(&view);
+    update_hill(street, &view);
+    street->valid = check_valid(street, &view);
     return street->valid;
 }
 
@@ -182,16 +343,14 @@ street_update(street_t *street)
  **************************************/
 
 int
-find_highest_first(street_t *street)
+find_highest_first(const street_view_t *view)
 {
-    int size = street->size;
+    int size = view->size;
     int highest = size - 1;
-    int mask = tower_get_mask(size, size);
+    unsigned int mask = 1u << (size - 1);
 
     for (int i = 0 ; i < size; i++) {
-        tower_t *tower = street_get_tower(street, i);
-
-        if (tower_has_floors(tower, mask)) {
+        if ((view->options[i] & mask) != 0) {
             highest = i;
             break;
         }
@@ -201,20 +360,18 @@ find_highest_first(street_t *street)
 }
 
 int
-find_highest_last(street_t *street)
+find_highest_last(const street_view_t *view)
 {
-    int size = street->size;
+    int size = view->size;
     int highest = size - 1;
-    int mask = tower_get_mask(size, size);
+    unsigned int mask = 1u << (size - 1);
 
     for (int i = 0 ; i < size; i++) {
-        tower_t *tower = street_get_tower(street, i);
-
-        if (tower_has_floors(tower, mask)) {
+        if ((view->options[i] & mask) != 0) {
             highest = i;
         }
 
-        if (tower_get_height(tower) == size) {
+        if (view->heights[i] == size) {
             break;
         }
     }
@@ -222,8 +379,22 @@ find_highest_last(street_t *street)
     return highest;
 }
 
+/** Наименьшая высота по этажам или 0 для пустых этажей. */
+static int
+min_height(unsigned int options)
+{
+    return options != 0 ? bits_lowest(options) + 1 : 0;
+}
+
+/** Наибольшая высота по этажам или 0 для пустых этажей. */
+static int
+max_height(unsigned int options)
+{
+    return options != 0 ? bits_highest(options) + 1 : 0;
+}
+
 void
-update_hill(street_t *street)
+update_hill(street_t *street, const street_view_t *view)
 {
     int size = street->size;
     /* Количество однозначно видимых построенных зданий текущего ряда.*/
@@ -248,8 +419,7 @@ update_hill(street_t *street)
 
     /* Сбор статистики идёт до последнего возможно самого высокого здания. */
     for (int i = 0; i  <= street->highest_last; i++) {
-        tower_t *tower = street_get_tower(street, i);
-        int height = tower_get_height(tower);
+        int height = view->heights[i];
 
         if (height == size) {
             total_visible++;
@@ -276,8 +446,8 @@ update_hill(street_t *street)
             bottom_limit = 0;
         }
 
-        int bottom = tower_get_min_height(tower);
-        int top = tower_get_max_height(tower);
+        int bottom = min_height(view->options[i]);
+        int top = max_height(view->options[i]);
 
         if (top > hills[hill_cnt].shadow && top > bottom_limit) {
             bottom_limit++;
@@ -327,11 +497,8 @@ check_info_reset(check_info_t *info)
 }
 
 static void
-check_info_add(check_info_t *info, tower_t *tower)
+check_info_add(check_info_t *info, int height, int options)
 {
-    int height = tower_get_height(tower);
-    int options = tower_get_options(tower);
-
     if (options == 0) {
         info->valid = false;
     }
@@ -342,7 +509,7 @@ check_info_add(check_info_t *info, tower_t *tower)
         if ((info->options & options) == 0) {
             info->valid = false;
         }
-    } else if (info->highest < tower_get_size(tower)) {
+    } else if (info->highest < info->size) {
         if (info->highest == 0) {
             info->foreground++;
         } else {
@@ -357,14 +524,14 @@ check_info_add(check_info_t *info, tower_t *tower)
 }
 
 bool
-check_valid(street_t *street)
+check_valid(street_t *street, const street_view_t *view)
 {
     check_info_t info;
+    info.size = street->size;
     check_info_reset(&info);
 
     for (int i = 0; i < street->size; i++) {
-        tower_t *tower = street_get_tower(street, i);
-        check_info_add(&info, tower);
+        check_info_add(&info, view->heights[i], (int) view->options[i]);
 
         if (!info.valid) {
             return false;
@@ -377,7 +544,23 @@ check_valid(street_t *street)
         return true;
     }
 
-    if (info.visible > clue + info.foreground + info.offstage) {
+    /* Построенное здание видно наверняка, только если оно выше всех возможных высот
+     * предыдущих зданий: недостроенное здание может закрыть любое количество построенных. */
+    int certain = 0;
+    int cover = 0;
+
+    for (int i = 0; i < street->size; i++) {
+        int height = view->heights[i];
+        int top = height != 0 ? height : max_height(view->options[i]);
+
+        if (height > cover) {
+            certain++;
+        }
+
+        cover = cover > top ? cover : top;
+    }
+
+    if (certain > clue) {
         return false;
     }
 
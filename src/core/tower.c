@@ -14,6 +14,7 @@
 #include <stddef.h>
 #include "skyskrapers/city.h"
 #include "skyskrapers/tower.h"
+#include "skyskrapers/bits.h"
 
 extern tower_t *
 tower_make(tower_t *in, city_t *parent, int x, int y)
@@ -46,7 +47,6 @@ tower_copy(tower_t *dst, const tower_t *src)
         return ret;
     }
 
-    ret->parent = src->parent;
     ret->x = src->x;
     ret->y = src->y;
     ret->height = src->height;
@@ -81,10 +81,22 @@ tower_set_height(tower_t *tower, int height)
     assert(height > 0 && height <= tower->size);
     assert(tower->height == 0 || tower->height == height);
     int old = tower->height;
+    int options = tower->options;
+
+    if (old != height || options != 1 << (height - 1)) {
+        city_trail_save(tower->parent, tower);
+    }
+
+    city_count_tower(tower->parent, tower, -1);
     tower->height = height;
     tower->options = 1 << (height - 1);
+    city_count_tower(tower->parent, tower, 1);
     bool changed = old != tower->height;
 
+    if (options != tower->options) {
+        city_notify_of_options_change(tower->parent, tower->x, tower->y, options ^ tower->options);
+    }
+
     if (changed) {
         city_notify_of_tower_change(tower->parent, tower->x, tower->y);
     }
@@ -127,28 +139,39 @@ tower_get_options(tower_t *tower)
     return tower->options;
 }
 
+/**
+ * Устанавливает допустимые этажи здания. Пустой набор этажей означает противоречие, он
+ * сразу учитывается в счётчике city_t::empty, который проверяет city_is_valid().
+ *
+ * @param tower Указатель на здание.
+ * @param options Набор битовых флагов допустимых этажей.
+ *
+ * @return true если набор изменился.
+ */
 int
 tower_set_options(tower_t *tower, int options)
 {
     assert(tower != NULL);
-    assert(options != 0);
     int old = tower->options;
-    tower->options = options;
+    int height = bits_height((unsigned int) options);
 
-    int t = 1;
+    if (old != options || (height != 0 && height != tower->height)) {
+        city_trail_save(tower->parent, tower);
+    }
 
-    for (int h = 1; h <= tower->size; h++) {
-        if (t == tower->options) {
-            tower->height = h;
-            break;
-        }
+    city_count_tower(tower->parent, tower, -1);
+    tower->options = options;
 
-        t <<= 1;
+    if (height != 0) {
+        tower->height = height;
     }
 
+    city_count_tower(tower->parent, tower, 1);
+
     bool changed = old != tower->options;
 
     if (changed) {
+        city_notify_of_options_change(tower->parent, tower->x, tower->y, old ^ tower->options);
         city_notify_of_tower_change(tower->parent, tower->x, tower->y);
     }
 
@@ -171,15 +194,7 @@ tower_get_min_height(const tower_t *tower)
         return 0;
     }
 
-    int mask = 1;
-    int ret = 1;
-
-    while (ret <= tower->size && (tower->options & mask) == 0) {
-        ret++;
-        mask <<= 1;
-    }
-
-    return ret;
+    return bits_lowest((unsigned int) tower->options) + 1;
 }
 
 /**
@@ -199,15 +214,7 @@ tower_get_max_height(const tower_t *tower)
         return 0;
     }
 
-    int mask = 1 << (tower->size - 1);
-    int ret = tower->size;
-
-    while (ret > 0 && (tower->options & mask) == 0) {
-        ret--;
-        mask >>= 1;
-    }
-
-    return ret;
+    return bits_highest((unsigned int) tower->options) + 1;
 }
 
 int
@@ -218,11 +225,5 @@ tower_get_mask(int bottom, int top)
         return 0;
     }
 
-    int mask = 1 << (bottom - 1);
-
-    for (; top > bottom; top--) {
-        mask |= mask << 1;
-    }
-
-    return mask;
+    return (int) bits_range(bottom, top);
 }
@@ -0,0 +1,115 @@
+/* utf-8 */
+
+/**
+ * @file
+ * @brief Генератор таблиц битовых операций.
+ * @details Программа записывает в файл, указанный первым аргументом, заголовок
+ * skyskrapers/bits_table.h со статическими таблицами для bits.h: маски диапазонов высот,
+ * младший и старший бит и количество битов байта, высоту по маске с одним битом. Таблицы
+ * строятся при сборке, чтобы не поддерживать их вручную.
+ *
+ * @date создан 19.10.2026
+ * @author Nick Egorrov
+ * @copyright http://www.apache.org/licenses/LICENSE-2.0
+ */
+
+#include <stdio.h>
+#include "skyskrapers/skyskrapers.h"
+
+/** Наибольший размер поля, для которого строятся маски диапазонов. */
+#define MAX_SIZE CITY_MAX_SIZE
+/** Остатки от деления степеней двойки 2^0 ... 2^31 на 37 различны. */
+#define MODULO 37
+
+static void
+print_table(FILE *out, const char *comment, const char *decl, const int *values, int count)
+{
+    fprintf(out, "/** %s */\nstatic const %s = {", comment, decl);
+
+    for (int i = 0; i < count; i++) {
+        fprintf(out, "%s%s%d", i == 0 ? "" : ",", i % 16 == 0 ? "\n    " : " ", values[i]);
+    }
+
+    fprintf(out, "\n};\n\n");
+}
+
+int
+main(int argc, char **argv)
+{
+    if (argc != 2) {
+        fprintf(stderr, "Usage: %s <header>\n", argv[0]);
+        return 1;
+    }
+
+    FILE *out = fopen(argv[1], "w");
+
+    if (out == NULL) {
+        perror(argv[1]);
+        return 1;
+    }
+
+    fprintf(out, "/* Сгенерировано программой src/gen/bits_table.c, не редактировать. */\n\n");
+    fprintf(out, "#ifndef _BITS_TABLE_H\n#define _BITS_TABLE_H\n\n");
+    fprintf(out, "#define BITS_TABLE_MAX_SIZE %d\n#define BITS_TABLE_MODULO %d\n\n", MAX_SIZE, MODULO);
+
+    int count[256], lowest[256], highest[256], height[MODULO] = {0};
+
+    for (int b = 0; b < 256; b++) {
+        count[b] = 0;
+        lowest[b] = -1;
+        highest[b] = -1;
+
+        for (int i = 0; i < 8; i++) {
+            if ((b & (1 << i)) != 0) {
+                count[b]++;
+                highest[b] = i;
+
+                if (lowest[b] < 0) {
+                    lowest[b] = i;
+                }
+            }
+        }
+    }
+
+    for (int i = 0; i < 32; i++) {
+        height[(1ul << i) % MODULO] = i + 1;
+    }
+
+    print_table(out, "Количество единичных битов байта.", "unsigned char bits_table_count[256]",
+                count, 256);
+    print_table(out, "Номер младшего единичного бита байта, -1 для нуля.",
+                "signed char bits_table_lowest[256]", lowest, 256);
+    print_table(out, "Номер старшего единичного бита байта, -1 для нуля.",
+                "signed char bits_table_highest[256]", highest, 256);
+    print_table(out, "Высота по остатку от деления маски с одним битом на BITS_TABLE_MODULO.",
+                "unsigned char bits_table_height[BITS_TABLE_MODULO]", height, MODULO);
+
+    fprintf(out, "/** Маски высот от bottom до top, индекс [bottom][top], пустые при bottom > top. */\n");
+    fprintf(out, "static const unsigned int bits_table_range[BITS_TABLE_MAX_SIZE + 1]"
+            "[BITS_TABLE_MAX_SIZE + 1] = {\n");
+
+    for (int bottom = 0; bottom <= MAX_SIZE; bottom++) {
+        fprintf(out, "    {");
+
+        for (int top = 0; top <= MAX_SIZE; top++) {
+            unsigned long mask = 0;
+
+            for (int h = bottom > 1 ? bottom : 1; h <= top; h++) {
+                mask |= 1ul << (h - 1);
+            }
+
+            fprintf(out, "%s%s0x%lxu", top == 0 ? "" : ",", top % 8 == 0 ? "\n        " : " ", mask);
+        }
+
+        fprintf(out, "\n    }%s\n", bottom < MAX_SIZE ? "," : "");
+    }
+
+    fprintf(out, "};\n\n#endif /* _BITS_TABLE_H */\n");
+
+    if (fclose(out) != 0) {
+        perror(argv[1]);
+        return 1;
+    }
+
+    return 0;
+}
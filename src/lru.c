@@ -0,0 +1,177 @@
+/* utf-8 */
+
+/**
+ * @file
+ * @brief Индекс кэша с вытеснением давно не использованных записей.
+ * @details Индекс общий для кэша решений и кэша улиц. Он хранит только хэши, цепочки
+ * корзин и порядок использования, а сами записи принадлежат кэшу и лежат в его массиве
+ * под теми же номерами, что и звенья индекса. Ключи сравнивает кэш: lru_first() и
+ * lru_next() перебирают записи с совпадающим хэшем. Пока индекс не заполнен,
+ * lru_insert() выдаёт следующий свободный номер, а потом вытесняет давно не
+ * использованную запись и возвращает её номер; кэш должен переписать ключ и значение
+ * этой записи. Вытеснения считает индекс, а попадания и промахи - кэш, в полях индекса.
+ *
+ * @date создан 19.10.2026
+ * @author Nick Egorrov
+ * @copyright http://www.apache.org/licenses/LICENSE-2.0
+ */
+
+#include <assert.h>
+#include <stdlib.h>
+#include "skyskrapers/lru.h"
+
+/*+************************************
+ *  Списки
+ **************************************/
+
+static void
+lru_unlink(lru_t *lru, int index)
+{
+    lru_link_t *link = &lru->links[index];
+
+    if (link->prev != LRU_NONE) {
+        lru->links[link->prev].next = link->next;
+    } else {
+        lru->head = link->next;
+    }
+
+    if (link->next != LRU_NONE) {
+        lru->links[link->next].prev = link->prev;
+    } else {
+        lru->tail = link->prev;
+    }
+}
+
+static void
+lru_push_front(lru_t *lru, int index)
+{
+    lru_link_t *link = &lru->links[index];
+    link->prev = LRU_NONE;
+    link->next = lru->head;
+
+    if (lru->head != LRU_NONE) {
+        lru->links[lru->head].prev = index;
+    } else {
+        lru->tail = index;
+    }
+
+    lru->head = index;
+}
+
+static void
+bucket_unlink(lru_t *lru, int index)
+{
+    int *link = &lru->buckets[lru->links[index].hash & lru->bucket_mask];
+
+    while (*link != index) {
+        assert(*link != LRU_NONE);
+        link = &lru->links[*link].chain;
+    }
+
+    *link = lru->links[index].chain;
+}
+
+/** Пропускает записи цепочки с другим хэшем. */
+static int
+chain_skip(const lru_t *lru, int index, unsigned int hash)
+{
+    while (index != LRU_NONE && lru->links[index].hash != hash) {
+        index = lru->links[index].chain;
+    }
+
+    return index;
+}
+
+/*+************************************
+ *  PUBLIC
+ **************************************/
+
+void
+lru_init(lru_t *lru, int capacity)
+{
+    assert(lru != NULL);
+    assert(capacity > 0);
+    unsigned int buckets = 1;
+
+    while (buckets < 2 * (unsigned int) capacity) {
+        buckets <<= 1;
+    }
+
+    lru->capacity = capacity;
+    lru->count = 0;
+    lru->bucket_mask = buckets - 1;
+    lru->buckets = malloc(buckets * sizeof(int));
+    lru->links = malloc((size_t) capacity * sizeof(lru_link_t));
+    assert(lru->buckets != NULL && lru->links != NULL);
+
+    for (unsigned int i = 0; i < buckets; i++) {
+        lru->buckets[i] = LRU_NONE;
+    }
+
+    lru->head = LRU_NONE;
+    lru->tail = LRU_NONE;
+    lru->hits = 0;
+    lru->misses = 0;
+    lru->evictions = 0;
+}
+
+void
+lru_destroy(lru_t *lru)
+{
+    assert(lru != NULL);
+    free(lru->links);
+    free(lru->buckets);
+}
+
+int
+lru_first(const lru_t *lru, unsigned int hash)
+{
+    return chain_skip(lru, lru->buckets[hash & lru->bucket_mask], hash);
+}
+
+int
+lru_next(const lru_t *lru, int index)
+{
+    return chain_skip(lru, lru->links[index].chain, lru->links[index].hash);
+}
+
+void
+lru_touch(lru_t *lru, int index)
+{
+    lru_unlink(lru, index);
+    lru_push_front(lru, index);
+}
+
+int
+lru_insert(lru_t *lru, unsigned int hash)
+{
+    int index;
+
+    if (lru->count < lru->capacity) {
+        index = lru->count++;
+    } else {
+        index = lru->tail;
+        lru_unlink(lru, index);
+        bucket_unlink(lru, index);
+        lru->evictions++;
+    }
+
+    lru_link_t *link = &lru->links[index];
+    link->hash = hash;
+    link->chain = lru->buckets[hash & lru->bucket_mask];
+    lru->buckets[hash & lru->bucket_mask] = index;
+    lru_push_front(lru, index);
+    return index;
+}
+
+void
+lru_get_stats(const lru_t *lru, cache_stats_t *stats)
+{
+    assert(lru != NULL);
+    assert(stats != NULL);
+    stats->capacity = lru->capacity;
+    stats->entries = lru->count;
+    stats->hits = lru->hits;
+    stats->misses = lru->misses;
+    stats->evictions = lru->evictions;
+}
@@ -0,0 +1,132 @@
+/* utf-8 */
+
+/**
+ * @file
+ * @brief Полная согласованность условия "все высоты ряда разные".
+ * @details Фильтр Режина. Здания и высоты ряда - доли двудольного графа, рёбра - допустимые
+ * этажи. Высота h допустима для здания, если ребро входит хотя бы в одно совершенное
+ * паросочетание. Для этого ищется любое совершенное паросочетание, а затем ребро оставляется,
+ * если оно входит в паросочетание или лежит в одной компоненте сильной связности
+ * ориентированного графа, где ребро паросочетания ведёт от высоты к зданию, а остальные рёбра -
+ * от здания к высоте. Паросочетание хранится в street_t::matching и служит начальным
+ * приближением при следующем вызове, поэтому повторный вызов для ряда с немного
+ * изменившимися этажами почти ничего не ищет.
+ *
+ * @date создан 19.10.2026
+ * @author Nick Egorrov
+ * @copyright http://www.apache.org/licenses/LICENSE-2.0
+ */
+
+#include "skyskrapers/street.h"
+#include "skyskrapers/tower.h"
+#include "skyskrapers/methods.h"
+#include "skyskrapers/bits.h"
+
+/**
+ * Ищет увеличивающую цепь от здания @p pos (алгоритм Куна).
+ *
+ * @param [in,out] seen Высоты, уже посещённые при поиске.
+ * @return true если паросочетание увеличено.
+ */
+static bool
+augment(int pos, const unsigned int *options, int *match, int *owner, unsigned int *seen)
+{
+    unsigned int rest = options[pos];
+
+    while ((rest &= ~*seen) != 0) {
+        int v = bits_lowest(rest);
+        *seen |= 1u << v;
+
+        if (owner[v] < 0 || augment(owner[v], options, match, owner, seen)) {
+            owner[v] = pos;
+            match[pos] = v;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool
+method_alldiff(const street_t *street)
+{
+    /* Улицы с противоположных сторон - это те же ряды. */
+    if (street->side > 1) {
+        return false;
+    }
+
+    int sz = street->size;
+    int *match = street->matching;
+    street_view_t view;
+    street_view_gather(&view, street);
+    unsigned int *options = view.options;
+    /* Здание, которому сопоставлена высота. */
+    int owner[32];
+
+    for (int k = 0; k < sz; k++) {
+        owner[k] = -1;
+    }
+
+    /* Сохранённое паросочетание, из которого убраны исчезнувшие рёбра. */
+    for (int k = 0; k < sz; k++) {
+        int v = match[k];
+
+        if (v >= 0 && (options[k] & (1u << v)) != 0 && owner[v] < 0) {
+            owner[v] = k;
+        } else {
+            match[k] = -1;
+        }
+    }
+
+    for (int k = 0; k < sz; k++) {
+        unsigned int seen = 0;
+
+        if (match[k] < 0 && !augment(k, options, match, owner, &seen)) {
+            /* Совершенного паросочетания нет, ряд противоречив. */
+            options[k] = 0;
+            street_view_scatter(&view);
+            return true;
+        }
+    }
+
+    /* Все высоты сопоставлены, поэтому из высоты ведёт ровно одно ребро и граф можно сжать
+     * до зданий: здание k ведёт к зданию owner[v] для каждой несопоставленной ему высоты v. */
+    unsigned int next[32], reach[32];
+
+    for (int k = 0; k < sz; k++) {
+        next[k] = 0;
+
+        for (unsigned int rest = options[k] & ~(1u << match[k]); rest != 0; rest &= rest - 1) {
+            next[k] |= 1u << owner[bits_lowest(rest)];
+        }
+    }
+
+    for (int k = 0; k < sz; k++) {
+        unsigned int front = next[k];
+        reach[k] = front;
+
+        while (front != 0) {
+            int j = bits_lowest(front);
+            front &= front - 1;
+            front |= next[j] & ~reach[k];
+            reach[k] |= next[j];
+        }
+    }
+
+    for (int k = 0; k < sz; k++) {
+        unsigned int keep = 1u << match[k];
+
+        for (unsigned int rest = options[k] & ~keep; rest != 0; rest &= rest - 1) {
+            int v = bits_lowest(rest);
+            int j = owner[v];
+
+            if ((reach[k] & (1u << j)) != 0 && (reach[j] & (1u << k)) != 0) {
+                keep |= 1u << v;
+            }
+        }
+
+        options[k] = keep;
+    }
+
+    return street_view_scatter(&view);
+}
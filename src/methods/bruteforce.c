@@ -15,17 +15,19 @@
 #include "skyskrapers/tower.h"
 #include "skyskrapers/methods.h"
 
-bool
+tower_t *
 method_bruteforce(city_t *city)
 {
     tower_t *tower;
-    int x = 0, y = 0, max = 0;
+    int x = 0, y = 0;
+    /* Суммы масок этажей ряда не помещаются в int уже для размера 26. */
+    long long max = 0;
 
     /* Вычисление оптимальной точки для перебора.
      * Сначала в каждой колонке этажи недостроенных зданий суммируются и эта сумма записывается
      * в поле weight зданий колонки.*/
     for (int iy = 0; iy < city->size; iy++) {
-        int sum = 0;
+        long long sum = 0;
 
         for (int ix = 0; ix < city->size; ix++) {
             tower = city_get_tower(city, 0, ix, iy);
@@ -45,7 +47,7 @@ method_bruteforce(city_t *city)
     /* Затем находится такие же суммы для строк и эти суммы плюсуются с полем weight. Попутно
      * запоминается недостроенное здание с самым большим весом. */
     for (int ix = 0; ix < city->size; ix++) {
-        int sum = 0;
+        long long sum = 0;
 
         for (int iy = 0; iy < city->size; iy++) {
             tower = city_get_tower(city, 0, ix, iy);
@@ -57,7 +59,7 @@ method_bruteforce(city_t *city)
 
         for (int iy = 0; iy < city->size; iy++) {
             tower = city_get_tower(city, 0, ix, iy);
-            int w = tower->weight + sum;
+            long long w = tower->weight + sum;
 
             if (!tower_is_complete(tower) && w > max) {
                 x = ix;
@@ -67,26 +69,5 @@ method_bruteforce(city_t *city)
         }
     }
 
-    /* Для возврата состояния города при неудачной попытке перебора делаем копию.
-     * А для перебора только допустимых высот заводим bit_enable. Это немного ускорит поиск. */
-    tower = city_get_tower(city, 0, x, y);
-    city_t *backup = city_copy(0, city);
-    int bit_enable = 1 << (city->size - 1);
-
-    for (int i = city->size; i > 0 ; i--) {
-        if (tower_has_floors(tower, bit_enable)) {
-            tower_set_height(tower, i);
-
-            if (city_solve(city)) {
-                city_free(backup);
-                return true;
-            }
-        }
-
-        bit_enable >>= 1;
-        city_copy(city, backup);
-    }
-
-    city_free(backup);
-    return false;
+    return max == 0 ? NULL : city_get_tower(city, 0, x, y);
 }
@@ -13,34 +13,37 @@
 #include "skyskrapers/street.h"
 #include "skyskrapers/tower.h"
 #include "skyskrapers/methods.h"
+#include "skyskrapers/bits.h"
 
 bool
 method_exclude(const street_t *street)
 {
-    bool changed = false;
     int sz = street->size;
 
-    if (street->side > 1) {
+    unsigned int fixed = street_get_fixed(street);
+
+    /* Высоты построенных раньше зданий уже исключены из остальных. */
+    if (street->side > 1 || fixed == 0) {
         return false;
     }
 
-    int options = tower_get_mask(1, sz);
+    street_view_t view;
+    street_view_gather(&view, street);
+    unsigned int options = (unsigned int) tower_get_mask(1, sz);
 
-    for (int i = 0; i < sz; i++) {
-        tower_t *tower = street_get_tower(street, i);
+    for (; fixed != 0; fixed &= fixed - 1) {
+        int i = bits_lowest(fixed);
 
-        if (tower_get_height(tower) != 0) {
-            options &= ~tower_get_options(tower);
+        if (view.heights[i] != 0) {
+            options &= ~view.options[i];
         }
     }
 
     for (int i = 0; i < sz; i++) {
-        tower_t *tower = street_get_tower(street, i);
-
-        if (tower_has_floors(tower, options) && tower_and_options(tower, options)) {
-            changed = true;
+        if ((view.options[i] & options) != 0) {
+            view.options[i] &= options;
         }
     }
 
-    return  changed;
+    return street_view_scatter(&view);
 }
@@ -13,47 +13,51 @@
 #include "skyskrapers/street.h"
 #include "skyskrapers/tower.h"
 #include "skyskrapers/methods.h"
+#include "skyskrapers/bits.h"
 
 bool
 method_first_of_two(const street_t *street)
 {
-    bool changed = false;
     int sz = street->size;
-
     int clue = street_get_clue(street);
-    tower_t *tower = street_get_tower(street, 0);
 
-    if (clue != 2 || tower_is_complete(tower)) {
+    if (clue != 2) {
         return false;
     }
 
-    int top = tower_get_mask(sz, sz);
-    int limit = tower_get_max_height(tower);
-    int mask = tower_get_mask(1, limit - 1);
+    street_view_t view;
+    street_view_gather(&view, street);
+    unsigned int *options = view.options;
 
-    for (int i = 1; i < sz; i++) {
-        tower = street_get_tower(street, i);
+    if (view.heights[0] != 0) {
+        return false;
+    }
+
+    unsigned int top = 1u << (sz - 1);
+    int limit = options[0] != 0 ? bits_highest(options[0]) + 1 : 0;
+    unsigned int mask = (unsigned int) tower_get_mask(1, limit - 1);
 
-        if (tower_get_height(tower) > limit) {
+    for (int i = 1; i < sz; i++) {
+        if (view.heights[i] > limit) {
             break;
         }
 
-        if (tower_is_complete(tower)) {
+        if (view.heights[i] != 0) {
             continue;
         }
 
-        if (tower_has_floors(tower, top)) {
-            if (tower_has_floors(tower, top | mask) && tower_and_options(tower, top | mask)) {
-                changed = true;
+        if ((options[i] & top) != 0) {
+            if ((options[i] & (top | mask)) != 0) {
+                options[i] &= top | mask;
             }
 
             break;
         }
 
-        if (tower_has_floors(tower, mask) && tower_and_options(tower, mask)) {
-            changed = true;
+        if ((options[i] & mask) != 0) {
+            options[i] &= mask;
         }
     }
 
-    return  changed;
+    return street_view_scatter(&view);
 }
@@ -0,0 +1,71 @@
+/* utf-8 */
+
+/**
+ * @file
+ * @brief Рыба (X-wing, swordfish) по строкам и столбцам.
+ * @details Для каждой высоты берутся битовые доски города: для строки - столбцы, где высота
+ * возможна, для столбца - строки. Если в k строках высота возможна только в k столбцах, то в
+ * этих столбцах высота стоит в этих строках и из остальных строк исключается. Поиск k строк
+ * тот же, что у открытого подмножества в ряду, см. method_find_subset().
+ *
+ * @date создан 19.10.2026
+ * @author Nick Egorrov
+ * @copyright http://www.apache.org/licenses/LICENSE-2.0
+ */
+
+#include "skyskrapers/city.h"
+#include "skyskrapers/tower.h"
+#include "skyskrapers/methods.h"
+
+/** Максимальный размер рыбы. Рыба больше половины поля дополняется рыбой меньшего размера
+ * в другом направлении. */
+#ifndef FISH_MAX
+#define FISH_MAX 4
+#endif
+
+bool
+method_fish(city_t *city)
+{
+    int sz = city->size;
+
+    for (int h = 0; h < sz; h++) {
+        int bit = 1 << h;
+        const unsigned int *rows = &city->rows[h * sz];
+        const unsigned int *cols = &city->cols[h * sz];
+
+        for (int k = 2; k <= FISH_MAX && 2 * k <= sz; k++) {
+            unsigned int members;
+            unsigned int join = method_find_subset(rows, sz, k, &members);
+
+            if (join != 0) {
+                /* members - строки, join - столбцы. */
+                for (int y = 0; y < sz; y++) {
+                    for (int x = 0; x < sz; x++) {
+                        if ((members & (1u << y)) == 0 && (join & rows[y] & (1u << x)) != 0) {
+                            tower_and_options(&city->towers[x + y * sz], ~bit);
+                        }
+                    }
+                }
+
+                return true;
+            }
+
+            join = method_find_subset(cols, sz, k, &members);
+
+            if (join != 0) {
+                /* members - столбцы, join - строки. */
+                for (int x = 0; x < sz; x++) {
+                    for (int y = 0; y < sz; y++) {
+                        if ((members & (1u << x)) == 0 && (join & cols[x] & (1u << y)) != 0) {
+                            tower_and_options(&city->towers[x + y * sz], ~bit);
+                        }
+                    }
+                }
+
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
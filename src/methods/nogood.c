@@ -0,0 +1,62 @@
+/* utf-8 */
+
+/**
+ * @file
+ * @brief Проверка запрещённых сочетаний решений.
+ * @details Сочетания запоминает пошаговый поиск, когда ветка перебора приводит к ошибке. Если
+ * все решения сочетания, кроме одного, уже выполнены, то оставшаяся высота исключается. Если
+ * выполнены все, город ошибочен.
+ *
+ * @date создан 19.10.2026
+ * @author Nick Egorrov
+ * @copyright http://www.apache.org/licenses/LICENSE-2.0
+ */
+
+#include "skyskrapers/city.h"
+#include "skyskrapers/tower.h"
+#include "skyskrapers/methods.h"
+#include "skyskrapers/search.h"
+
+bool
+method_nogood(city_t *city)
+{
+    const search_t *search = city->search;
+
+    if (search == NULL) {
+        return false;
+    }
+
+    for (int n = 0; n < search->nogood_count; n++) {
+        const nogood_t *nogood = &search->nogoods[n];
+        /* Единственное невыполненное решение. */
+        int open = -1;
+        bool blocked = false;
+
+        for (int i = 0; i < nogood->size && !blocked; i++) {
+            const tower_t *tower = &city->towers[nogood->tower[i]];
+            int height = nogood->height[i];
+
+            if (tower->height == height) {
+                continue;
+            }
+
+            blocked = open >= 0 || (tower->options & (1 << (height - 1))) == 0;
+            open = i;
+        }
+
+        if (blocked) {
+            continue;
+        }
+
+        if (open < 0) {
+            tower_set_options(&city->towers[nogood->tower[0]], 0);
+        } else {
+            int bit = 1 << (nogood->height[open] - 1);
+            tower_and_options(&city->towers[nogood->tower[open]], ~bit);
+        }
+
+        return true;
+    }
+
+    return false;
+}
@@ -10,42 +10,39 @@
  * @copyright http://www.apache.org/licenses/LICENSE-2.0
  */
 
+#include "skyskrapers/city.h"
 #include "skyskrapers/street.h"
 #include "skyskrapers/tower.h"
 #include "skyskrapers/methods.h"
+#include "skyskrapers/bits.h"
 
 bool
 method_obvious(const street_t *street)
 {
-    bool changed = false;
-    int sz = street->size;
-    int options = 1 << sz;
-
-    for (int h = sz; h > 0; h--) {
-        options >>= 1;
-
-        tower_t *highest = 0;
+    /* Противоположные улицы проходят по одному ряду. */
+    if (street->side > 1) {
+        return false;
+    }
 
-        for (int i = 0; i < sz; i++) {
-            tower_t *tower = street_get_tower(street, i);
+    city_t *city = street->parent;
+    int sz = street->size;
+    int pos = street->pos;
+    bool column = street->side == 0;
+    const unsigned int *board = column ? city->cols : city->rows;
+    bool changed = false;
 
-            if (tower_get_height(tower) == h) {
-                highest = 0;
-                break;
-            }
+    for (int h = 1; h <= sz; h++) {
+        unsigned int places = board[(h - 1) * sz + pos];
 
-            if (tower_has_floors(tower, options)) {
-                if (highest == 0) {
-                    highest = tower;
-                } else {
-                    highest = 0;
-                    break;
-                }
-            }
+        if (!bits_is_single(places)) {
+            continue;
         }
 
-        if (highest != 0) {
-            tower_set_height(highest, h);
+        int i = bits_lowest(places);
+        tower_t *tower = column ? &city->towers[pos + i * sz] : &city->towers[i + pos * sz];
+
+        if (tower_get_height(tower) == 0) {
+            tower_set_height(tower, h);
             changed = true;
         }
     }
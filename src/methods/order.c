@@ -0,0 +1,122 @@
+/* utf-8 */
+
+/**
+ * @file
+ * @brief Порядок высот в точке выбора перебора.
+ * @details Высоты точки выбора пробуются по очереди, и хороший порядок приводит к первому
+ * решению за меньшее число узлов. Порядок вычисляется заново перед каждой высотой из
+ * состояния точки выбора, которое после отката по следу всегда одно и то же, поэтому
+ * сохранённый поиск продолжается в том же порядке.
+ *
+ * ORDER_LCV оценивает высоту по битовым доскам: сколько других зданий строки и столбца
+ * потеряют этот этаж. ORDER_SUPPORT перемножает доли расстановок видимости, совместимых с
+ * высотой, по всем рядам здания с подсказкой, см. method_visibility_support().
+ *
+ * @date создан 19.10.2026
+ * @author Nick Egorrov
+ * @copyright http://www.apache.org/licenses/LICENSE-2.0
+ */
+
+#include <assert.h>
+#include "skyskrapers/skyskrapers.h"
+#include "skyskrapers/city.h"
+#include "skyskrapers/street.h"
+#include "skyskrapers/methods.h"
+#include "skyskrapers/bits.h"
+
+/** Самая высокая из непроверенных высот. */
+static int
+order_descending(int remaining)
+{
+    return bits_highest((unsigned int) remaining) + 1;
+}
+
+/** Высота, которую теряет меньше всего других зданий строки и столбца. */
+static int
+order_lcv(const city_t *city, int tower, int remaining)
+{
+    int sz = city->size;
+    int x = tower % sz, y = tower / sz;
+    int best = 0, best_cost = 0;
+
+    /* Сверху вниз, чтобы при равной цене оставалась более высокая высота. */
+    for (int h = sz; h >= 1; h--) {
+        if ((remaining & (1 << (h - 1))) == 0) {
+            continue;
+        }
+
+        int cost = bits_count(city->rows[(h - 1) * sz + y] & ~(1u << x))
+                   + bits_count(city->cols[(h - 1) * sz + x] & ~(1u << y));
+
+        if (best == 0 || cost < best_cost) {
+            best = h;
+            best_cost = cost;
+        }
+    }
+
+    return best;
+}
+
+/** Высота с наибольшей долей расстановок видимости во всех рядах с подсказкой. */
+static int
+order_support(const city_t *city, int tower, int remaining)
+{
+    int sz = city->size;
+    int x = tower % sz, y = tower / sz;
+    /* Улицы через здание и его номер на каждой из них. */
+    int streets[4] = {x, sz + y, 3 * sz - x - 1, 4 * sz - y - 1};
+    int indexes[4] = {y, sz - 1 - x, sz - 1 - y, x};
+    double score[CITY_MAX_SIZE];
+    double support[CITY_MAX_SIZE];
+
+    for (int h = 0; h < sz; h++) {
+        score[h] = 1;
+    }
+
+    for (int j = 0; j < 4; j++) {
+        const street_t *street = &city->streets[streets[j]];
+
+        if (street_get_clue(street) == 0) {
+            continue;
+        }
+
+        method_visibility_support(street, indexes[j], support);
+        double total = 0;
+
+        for (int h = 0; h < sz; h++) {
+            total += support[h];
+        }
+
+        for (int h = 0; h < sz && total > 0; h++) {
+            score[h] *= support[h] / total;
+        }
+    }
+
+    int best = 0;
+
+    for (int h = sz; h >= 1; h--) {
+        if ((remaining & (1 << (h - 1))) != 0 && (best == 0 || score[h - 1] > score[best - 1])) {
+            best = h;
+        }
+    }
+
+    return best;
+}
+
+int
+method_order_height(const city_t *city, int tower, int remaining)
+{
+    assert(city != NULL);
+    assert(remaining != 0);
+
+    switch (city->value_order) {
+    case ORDER_LCV:
+        return order_lcv(city, tower, remaining);
+
+    case ORDER_SUPPORT:
+        return order_support(city, tower, remaining);
+
+    default:
+        return order_descending(remaining);
+    }
+}
@@ -0,0 +1,264 @@
+/* utf-8 */
+
+/**
+ * @file
+ * @brief Пробы высот перед перебором.
+ * @details Когда эвристики ничего не дают, каждой возможной высоте каждого недостроенного
+ * здания делается проба: на копии города здание строится этой высоты, и копия решается
+ * дешёвыми методами до неподвижной точки. Если копия стала ошибочной, высота исключается.
+ * Если копия решена, решение переносится в город. Копия делается один раз на поток, а между
+ * пробами возвращается снимком (city_snapshot_restore()), который переписывает только
+ * затронутые пробой строки и улицы. Здания пробуются параллельно в нескольких
+ * потоках, у каждого потока своя копия, а исходный город во время проб только читается.
+ *
+ * @date создан 19.10.2026
+ * @author Nick Egorrov
+ * @copyright http://www.apache.org/licenses/LICENSE-2.0
+ */
+
+#include <assert.h>
+#include "skyskrapers/skyskrapers.h"
+#include "skyskrapers/city.h"
+#include "skyskrapers/tower.h"
+#include "skyskrapers/methods.h"
+
+/* Без атомарных встроенных функций пробы выполняются в вызывающем потоке. */
+#if defined(HAVE_PTHREAD) && defined(__GNUC__)
+#include <pthread.h>
+#define PROBE_THREADS
+#define FETCH_ADD(ptr, value) __atomic_fetch_add(ptr, value, __ATOMIC_RELAXED)
+#define LOAD(ptr) __atomic_load_n(ptr, __ATOMIC_ACQUIRE)
+#define STORE(ptr, value) __atomic_store_n(ptr, value, __ATOMIC_RELEASE)
+#define PUBLISH(ptr, expected, value) \
+    __atomic_compare_exchange_n(ptr, expected, value, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)
+#else
+#define FETCH_ADD(ptr, value) ((*(ptr) += (value)) - (value))
+#define LOAD(ptr) (*(ptr))
+#define STORE(ptr, value) (*(ptr) = (value))
+#define PUBLISH(ptr, expected, value) (*(ptr) = (value), true)
+#endif
+
+/** Дешёвые методы для решения копии. */
+#define PROBE_METHODS (METHOD_OBVIOUS | METHOD_EXCLUDE | METHOD_VISIBILITY)
+
+enum _probe_result {
+    PROBE_OPEN,
+    PROBE_FAILED,
+    PROBE_SOLVED
+};
+
+typedef struct _prober {
+    /** Исходный город, во время проб только читается. */
+    const city_t *city;
+    /** Ограничения решения или NULL. */
+    const solve_options_t *options;
+    /** Максимальное количество проб, 0 - без ограничения. */
+    unsigned long limit;
+    /** Недостроенные здания, индексы в city_t::towers. */
+    const int *cells;
+    int count;
+    /** Исключённые высоты каждого здания из cells. */
+    int *removed;
+    /** Следующее здание для проб. */
+    int next;
+    /** Количество начатых проб. */
+    unsigned long probes;
+    /** Пробы нужно прекратить. */
+    int stop;
+    /** Первая решённая копия. */
+    city_t *solution;
+} prober_t;
+
+/**
+ * Копирует город для потока проб. Копия берёт память у malloc(), а не у распределителя
+ * города: потоки не должны вызывать его одновременно.
+ */
+static city_t *
+probe_copy(const city_t *city)
+{
+    return city_copy(city_new(city->size), city);
+}
+
+/**
+ * Готовит копию города для проб и подключает к ней снимок.
+ */
+static void
+probe_prepare(city_t *copy, const city_t *city, snapshot_t *snapshot)
+{
+    copy->methods = city->methods & PROBE_METHODS;
+    copy->log = NULL;
+    copy->control = NULL;
+    /* Кэш рядов не потокобезопасен. */
+    copy->street_cache = NULL;
+    city_snapshot_take(copy, snapshot);
+}
+
+/**
+ * Пробует высоту здания на копии со снимком. Копия остаётся изменённой до
+ * city_snapshot_restore().
+ */
+static int
+probe(city_t *copy, int tower, int height)
+{
+    tower_set_height(&copy->towers[tower], height);
+
+    for (;;) {
+        if (!city_is_valid(copy)) {
+            return PROBE_FAILED;
+        }
+
+        if (city_is_solved(copy)) {
+            return PROBE_SOLVED;
+        }
+
+        if (!city_solve_step(copy)) {
+            return PROBE_OPEN;
+        }
+    }
+}
+
+static bool
+probe_expired(prober_t *prober)
+{
+    if (prober->limit != 0 && FETCH_ADD(&prober->probes, 1ul) >= prober->limit) {
+        return true;
+    }
+
+    return prober->options != NULL && solve_options_expired(prober->options, true);
+}
+
+static void *
+probe_worker(void *arg)
+{
+    prober_t *prober = arg;
+    const city_t *city = prober->city;
+    city_t *copy = probe_copy(city);
+    snapshot_t *snapshot = city_snapshot_new(copy);
+    probe_prepare(copy, city, snapshot);
+
+    for (;;) {
+        int i = FETCH_ADD(&prober->next, 1);
+
+        if (i >= prober->count || LOAD(&prober->stop)) {
+            break;
+        }
+
+        int options = city->towers[prober->cells[i]].options;
+
+        for (int h = 1; h <= city->size; h++) {
+            if ((options & (1 << (h - 1))) == 0) {
+                continue;
+            }
+
+            if (probe_expired(prober)) {
+                STORE(&prober->stop, 1);
+                break;
+            }
+
+            int result = probe(copy, prober->cells[i], h);
+
+            if (result == PROBE_FAILED) {
+                prober->removed[i] |= 1 << (h - 1);
+                STORE(&prober->stop, 1);
+            } else if (result == PROBE_SOLVED) {
+                city_t *expected = NULL;
+                copy->snapshot = NULL;
+
+                if (PUBLISH(&prober->solution, &expected, copy)) {
+                    /* Снимок освобождается в памяти города, в которой создан. */
+                    city_snapshot_free(snapshot);
+                    copy = probe_copy(city);
+                    snapshot = city_snapshot_new(copy);
+                    probe_prepare(copy, city, snapshot);
+                }
+
+                STORE(&prober->stop, 1);
+                break;
+            }
+
+            city_snapshot_restore(copy);
+        }
+    }
+
+    /* Снимок создан в памяти текущей копии. */
+    city_snapshot_free(snapshot);
+    city_free(copy);
+    return NULL;
+}
+
+bool
+method_probe(city_t *city)
+{
+    assert(city != NULL);
+    int sz = city->size;
+    size_t cells_size = (size_t) (sz * sz) * sizeof(int);
+    int *cells = memory_alloc(&city->memory, cells_size);
+    int *removed = memory_calloc(&city->memory, (size_t) (sz * sz), sizeof(int));
+    const solve_options_t *options = city->control ? city->control->options : NULL;
+    prober_t prober = {city, options, 0, cells, 0, removed, 0, 0, 0, NULL};
+    int threads = 1;
+
+    for (int i = 0; i < sz * sz; i++) {
+        if (city->towers[i].height == 0) {
+            cells[prober.count++] = i;
+        }
+    }
+
+    if (prober.count == 0) {
+        memory_free(&city->memory, cells, cells_size);
+        memory_free(&city->memory, removed, cells_size);
+        return false;
+    }
+
+    if (options != NULL) {
+        prober.limit = options->probe_limit;
+        threads = options->probe_threads > threads ? options->probe_threads : threads;
+    }
+
+    threads = threads < prober.count ? threads : prober.count;
+
+#ifdef PROBE_THREADS
+    size_t workers_size = (size_t) threads * sizeof(pthread_t);
+    pthread_t *workers = memory_alloc(&city->memory, workers_size);
+    int started = 0;
+
+    for (; started < threads - 1; started++) {
+        if (pthread_create(&workers[started], NULL, probe_worker, &prober) != 0) {
+            break;
+        }
+    }
+
+    probe_worker(&prober);
+
+    for (int i = 0; i < started; i++) {
+        pthread_join(workers[i], NULL);
+    }
+
+    memory_free(&city->memory, workers, workers_size);
+#else
+    probe_worker(&prober);
+#endif
+
+    bool changed = false;
+
+    if (prober.solution != NULL) {
+        /* Решение переносится по зданиям, чтобы изменения попали в след поиска. */
+        for (int i = 0; i < sz * sz; i++) {
+            tower_set_options(&city->towers[i], prober.solution->towers[i].options);
+        }
+
+        city_free(prober.solution);
+        changed = true;
+    } else {
+        for (int i = 0; i < prober.count; i++) {
+            if (removed[i] != 0) {
+                tower_and_options(&city->towers[cells[i]], ~removed[i]);
+                changed = true;
+            }
+        }
+    }
+
+    memory_free(&city->memory, cells, cells_size);
+    memory_free(&city->memory, removed, cells_size);
+    return changed;
+}
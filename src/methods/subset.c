@@ -0,0 +1,186 @@
+/* utf-8 */
+
+/**
+ * @file
+ * @brief Исключение подмножеств.
+ * @details Если k недостроенных зданий ряда вместе допускают ровно k высот (открытое
+ * подмножество), то эти высоты исключаются из остальных зданий ряда. Если k высот ряда
+ * допускают ровно k зданий (скрытое подмножество), то у этих зданий остаются только эти
+ * высоты. Подмножества ищутся перебором с отсечением по объединению битовых масок этажей
+ * недостроенных зданий или зданий свободных высот.
+ *
+ * @date создан 19.10.2026
+ * @author Nick Egorrov
+ * @copyright http://www.apache.org/licenses/LICENSE-2.0
+ */
+
+#include "skyskrapers/street.h"
+#include "skyskrapers/tower.h"
+#include "skyskrapers/methods.h"
+#include "skyskrapers/bits.h"
+
+/** Максимальный размер подмножества. Одиночки обрабатывают method_exclude() и
+ * method_obvious(), а подмножество больше половины свободных зданий дополняется подмножеством
+ * меньшего размера другого вида. */
+#ifndef SUBSET_MAX
+#define SUBSET_MAX 4
+#endif
+
+/** Подмножество что-то исключает, если объединение пересекается с элементом вне его. */
+static bool
+is_productive(const unsigned int *sets, int count, unsigned int members, unsigned int join)
+{
+    for (int i = 0; i < count; i++) {
+        if ((members & (1u << i)) == 0 && (sets[i] & join) != 0) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * Ищет подмножество размера @p k среди @p count элементов, которое что-то исключает. Элементы
+ * добавляются по возрастанию номера, ветка отбрасывается, как только объединение превысит @p k
+ * высот или зданий, поэтому в ряду с широкими этажами перебор почти сразу заканчивается.
+ *
+ * @param sets Для открытого подмножества - этажи зданий, для скрытого - маски зданий, в которых
+ * возможна высота.
+ * @param count Количество элементов.
+ * @param k Размер подмножества.
+ * @param from Первый элемент для добавления.
+ * @param join Объединение уже выбранных элементов.
+ * @param [out] members Номера элементов подмножества битами.
+ * @return Объединение элементов подмножества или 0, если подмножество не найдено.
+ */
+static unsigned int
+find_subset(const unsigned int *sets, int count, int k, int from, unsigned int join,
+            unsigned int *members)
+{
+    int chosen = bits_count(*members);
+
+    for (int i = from; i <= count - (k - chosen); i++) {
+        unsigned int next = join | sets[i];
+
+        if (bits_count(next) > k) {
+            continue;
+        }
+
+        *members |= 1u << i;
+
+        if (chosen + 1 == k) {
+            if (is_productive(sets, count, *members, next)) {
+                return next;
+            }
+        } else {
+            unsigned int found = find_subset(sets, count, k, i + 1, next, members);
+
+            if (found != 0) {
+                return found;
+            }
+        }
+
+        *members &= ~(1u << i);
+    }
+
+    return 0;
+}
+
+unsigned int
+method_find_subset(const unsigned int *sets, int count, int k, unsigned int *members)
+{
+    *members = 0;
+    return find_subset(sets, count, k, 0, 0, members);
+}
+
+bool
+method_subset(const street_t *street)
+{
+    /* Улицы с противоположных сторон - это те же ряды. */
+    if (street->side > 1) {
+        return false;
+    }
+
+    int sz = street->size;
+    street_view_t view;
+    street_view_gather(&view, street);
+    unsigned int *options = view.options;
+    /* Недостроенные здания и свободные высоты в сжатой нумерации. */
+    int cells[32], cell_count = 0;
+    int values[32], value_count = 0;
+    unsigned int free_values = (unsigned int) tower_get_mask(1, sz);
+
+    for (int i = 0; i < sz; i++) {
+        if (view.heights[i] != 0) {
+            free_values &= ~options[i];
+        } else {
+            cells[cell_count++] = i;
+        }
+    }
+
+    for (int h = 0; h < sz; h++) {
+        if ((free_values & (1u << h)) != 0) {
+            values[value_count++] = h;
+        }
+    }
+
+    if (cell_count != value_count) {
+        return false;
+    }
+
+    unsigned int cell_sets[32], value_sets[32];
+
+    for (int c = 0; c < cell_count; c++) {
+        cell_sets[c] = options[cells[c]] & free_values;
+    }
+
+    for (int v = 0; v < value_count; v++) {
+        value_sets[v] = 0;
+
+        for (int c = 0; c < cell_count; c++) {
+            if ((cell_sets[c] & (1u << values[v])) != 0) {
+                value_sets[v] |= 1u << c;
+            }
+        }
+    }
+
+    bool changed = false;
+
+    for (int k = 2; k <= SUBSET_MAX && 2 * k <= cell_count && !changed; k++) {
+        unsigned int members;
+        unsigned int join = method_find_subset(cell_sets, cell_count, k, &members);
+
+        if (join != 0) {
+            /* Открытое подмножество: join - высоты, members - здания в сжатой нумерации. */
+            for (int c = 0; c < cell_count; c++) {
+                if ((members & (1u << c)) == 0 && (cell_sets[c] & join) != 0) {
+                    options[cells[c]] &= ~join;
+                    changed = true;
+                }
+            }
+        }
+
+        join = method_find_subset(value_sets, value_count, k, &members);
+
+        if (join != 0) {
+            /* Скрытое подмножество: join - здания, members - высоты в сжатой нумерации. */
+            unsigned int keep = 0;
+
+            for (int v = 0; v < value_count; v++) {
+                if ((members & (1u << v)) != 0) {
+                    keep |= 1u << values[v];
+                }
+            }
+
+            for (int c = 0; c < cell_count; c++) {
+                if ((join & (1u << c)) != 0 && (cell_sets[c] & ~keep) != 0) {
+                    options[cells[c]] &= keep;
+                    changed = true;
+                }
+            }
+        }
+    }
+
+    street_view_scatter(&view);
+    return changed;
+}
@@ -0,0 +1,212 @@
+/* utf-8 */
+
+/**
+ * @file
+ * @brief Точное ограничение видимости.
+ * @details Ряд с подсказкой просматривается как автомат с состоянием (максимальная высота m,
+ * количество видимых зданий v). Прямой проход находит состояния, достижимые перед каждым
+ * зданием, обратный - состояния, из которых можно дойти до конца ряда ровно с подсказкой
+ * видимых зданий и самым высоким зданием в ряду. Высота здания остаётся допустимой, если она
+ * переводит достижимое состояние в состояние, из которого конец ряда достижим.
+ *
+ * Условие разных высот учитывается только частично: скрытое здание ниже m, а не равно ему, и
+ * перед зданием k уже построено k разных высот, поэтому m не меньше k. Количества видимых
+ * зданий хранятся битами, поэтому оба прохода занимают O(N^3) операций.
+ *
+ * @date создан 19.10.2026
+ * @author Nick Egorrov
+ * @copyright http://www.apache.org/licenses/LICENSE-2.0
+ */
+
+#include <assert.h>
+#include "skyskrapers/skyskrapers.h"
+#include "skyskrapers/city.h"
+#include "skyskrapers/street.h"
+#include "skyskrapers/tower.h"
+#include "skyskrapers/methods.h"
+#include "skyskrapers/bits.h"
+
+bool
+method_visibility(const street_t *street)
+{
+    int clue = street_get_clue(street);
+
+    if (clue == 0) {
+        return false;
+    }
+
+    int sz = street->size;
+    street_view_t view;
+    street_view_gather(&view, street);
+    unsigned int *options = view.options;
+    /* Биты v количества видимых зданий для состояний перед зданием k с максимальной высотой m,
+     * индекс k * (CITY_MAX_SIZE + 1) + m. */
+    unsigned int forward[(CITY_MAX_SIZE + 1) * (CITY_MAX_SIZE + 1)] = {0};
+    unsigned int backward[(CITY_MAX_SIZE + 1) * (CITY_MAX_SIZE + 1)] = {0};
+#define AT(k, m) ((k) * (CITY_MAX_SIZE + 1) + (m))
+
+    forward[AT(0, 0)] = 1;
+
+    for (int k = 0; k < sz; k++) {
+        for (int m = k; m <= sz; m++) {
+            unsigned int v = forward[AT(k, m)];
+
+            if (v == 0) {
+                continue;
+            }
+
+            for (int h = 1; h <= sz; h++) {
+                if ((options[k] & (1u << (h - 1))) == 0) {
+                    continue;
+                }
+
+                if (h > m) {
+                    forward[AT(k + 1, h)] |= v << 1;
+                } else if (h < m && m > k) {
+                    forward[AT(k + 1, m)] |= v;
+                }
+            }
+        }
+    }
+
+    backward[AT(sz, sz)] = 1u << clue;
+
+    for (int k = sz - 1; k >= 0; k--) {
+        for (int m = k; m <= sz; m++) {
+            unsigned int v = 0;
+
+            for (int h = 1; h <= sz; h++) {
+                if ((options[k] & (1u << (h - 1))) == 0) {
+                    continue;
+                }
+
+                if (h > m) {
+                    v |= backward[AT(k + 1, h)] >> 1;
+                } else if (h < m && m > k) {
+                    v |= backward[AT(k + 1, m)];
+                }
+            }
+
+            backward[AT(k, m)] = v;
+        }
+    }
+
+    for (int k = 0; k < sz; k++) {
+        unsigned int keep = 0;
+
+        for (int h = 1; h <= sz; h++) {
+            if ((options[k] & (1u << (h - 1))) == 0) {
+                continue;
+            }
+
+            for (int m = k; m <= sz; m++) {
+                unsigned int next = h > m ? backward[AT(k + 1, h)] >> 1 : backward[AT(k + 1, m)];
+
+                if ((h > m || (h < m && m > k)) && (forward[AT(k, m)] & next) != 0) {
+                    keep |= 1u << (h - 1);
+                    break;
+                }
+            }
+        }
+
+        options[k] = keep;
+    }
+
+#undef AT
+    return street_view_scatter(&view);
+}
+
+void
+method_visibility_support(const street_t *street, int index, double *support)
+{
+    int clue = street_get_clue(street);
+    int sz = street->size;
+    assert(clue > 0);
+    assert(index >= 0 && index < sz);
+    street_view_t view;
+    street_view_gather(&view, street);
+    unsigned int *options = view.options;
+    /* Количества расстановок для состояний (k, m, v): перед зданием k, максимальная высота m,
+     * видно v зданий. Прямые - от края ряда до состояния, обратные - от состояния до конца
+     * ряда с подсказкой и самым высоким зданием. */
+    int width = clue + 2;
+    size_t count = (size_t) ((sz + 1) * (sz + 1) * width);
+    memory_t *memory = &street->parent->memory;
+    double *forward = memory_calloc(memory, count, sizeof(double));
+    double *backward = memory_calloc(memory, count, sizeof(double));
+#define AT(k, m, v) (((k) * (sz + 1) + (m)) * width + (v))
+
+    forward[AT(0, 0, 0)] = 1;
+
+    for (int k = 0; k < index; k++) {
+        for (int m = k; m <= sz; m++) {
+            for (int v = 0; v <= clue; v++) {
+                double f = forward[AT(k, m, v)];
+
+                if (f <= 0) {
+                    continue;
+                }
+
+                for (unsigned int rest = options[k]; rest != 0; rest &= rest - 1) {
+                    int h = bits_lowest(rest) + 1;
+
+                    if (h > m) {
+                        forward[AT(k + 1, h, v + 1)] += f;
+                    } else if (h < m && m > k) {
+                        forward[AT(k + 1, m, v)] += f;
+                    }
+                }
+            }
+        }
+    }
+
+    backward[AT(sz, sz, clue)] = 1;
+
+    for (int k = sz - 1; k > index; k--) {
+        for (int m = k; m <= sz; m++) {
+            for (int v = 0; v <= clue; v++) {
+                double b = 0;
+
+                for (unsigned int rest = options[k]; rest != 0; rest &= rest - 1) {
+                    int h = bits_lowest(rest) + 1;
+
+                    if (h > m) {
+                        b += backward[AT(k + 1, h, v + 1)];
+                    } else if (h < m && m > k) {
+                        b += backward[AT(k + 1, m, v)];
+                    }
+                }
+
+                backward[AT(k, m, v)] = b;
+            }
+        }
+    }
+
+    for (int h = 1; h <= sz; h++) {
+        support[h - 1] = 0;
+
+        if ((options[index] & (1u << (h - 1))) == 0) {
+            continue;
+        }
+
+        for (int m = index; m <= sz; m++) {
+            for (int v = 0; v <= clue; v++) {
+                double f = forward[AT(index, m, v)];
+
+                if (f <= 0) {
+                    continue;
+                }
+
+                if (h > m) {
+                    support[h - 1] += f * backward[AT(index + 1, h, v + 1)];
+                } else if (h < m && m > index) {
+                    support[h - 1] += f * backward[AT(index + 1, m, v)];
+                }
+            }
+        }
+    }
+
+#undef AT
+    memory_free(memory, forward, count * sizeof(double));
+    memory_free(memory, backward, count * sizeof(double));
+}
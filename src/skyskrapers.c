@@ -10,42 +10,154 @@
  * @copyright http://www.apache.org/licenses/LICENSE-2.0
  */
 
+#include <assert.h>
+#include <limits.h>
+#include <stdarg.h>
 #include <stdio.h>
+#include <string.h>
+#include <time.h>
 
 #include "skyskrapers/skyskrapers.h"
 #include "skyskrapers/city.h"
 #include "skyskrapers/street.h"
+#include "skyskrapers/tower.h"
 #include "skyskrapers/methods.h"
+#include "skyskrapers/search.h"
+#include "skyskrapers/street_cache.h"
+#include "skyskrapers/bits.h"
 
 struct _handler {
     char *name;
+    unsigned int id;
     bool (* func)(const street_t *street);
 } handlers[] = {
-    {"obvious", method_obvious},
-    {"exclude", method_exclude},
-    {"first of two", method_first_of_two},
-    {"staircase", method_staircase},
-    {"step down", method_step_down},
-    {"slope", method_slope}
+    {"obvious", METHOD_OBVIOUS, method_obvious},
+    {"exclude", METHOD_EXCLUDE, method_exclude},
+    {"subset", METHOD_SUBSET, method_subset},
+    {"alldiff", METHOD_ALLDIFF, method_alldiff},
+    {"visibility", METHOD_VISIBILITY, method_visibility},
+    {"first of two", METHOD_FIRST_OF_TWO, method_first_of_two},
+    {"staircase", METHOD_STAIRCASE, method_staircase},
+    {"step down", METHOD_STEP_DOWN, method_step_down},
+    {"slope", METHOD_SLOPE, method_slope}
 };
 
+#define HANDLER_COUNT (sizeof(handlers) / sizeof(struct _handler))
+
+/**
+ * Выполняет эвристики ряда до неподвижной точки, используя кэш рядов.
+ *
+ * @return true если эвристики изменили ряд.
+ */
+static bool
+handle_cached(city_t *city, int index)
+{
+    street_t *street = &city->streets[index];
+    unsigned int methods = 0;
+    street_view_t before, after;
+    bool changed = false;
+
+    for (size_t j = 0; j < HANDLER_COUNT; j++) {
+        methods |= handlers[j].id;
+    }
+
+    methods &= city->methods;
+    street_view_gather(&before, street);
+    /* Кэш хранит этажи как int, представление - как unsigned int того же размера. */
+    const int *options = (const int *) before.gathered;
+
+    if (street_cache_find(city->street_cache, methods, street, options, (int *) before.options)) {
+        changed = street_view_scatter(&before);
+
+        if (changed) {
+            city_log(city, "Pass street cache\n");
+        }
+
+        /* Результат уже неподвижная точка эвристик ряда. */
+        bits_reset(city->need_handle, index);
+        city_clear_delta(city, index);
+        return changed;
+    }
+
+    for (;;) {
+        /* Ошибочный ряд обнаружит city_is_valid(), результат для него не нужен. */
+        if (!city_update_street(city, index)) {
+            return changed;
+        }
+
+        size_t j = 0;
+
+        while (j < HANDLER_COUNT
+                && ((city->methods & handlers[j].id) == 0 || !handlers[j].func(street))) {
+            j++;
+        }
+
+        if (j == HANDLER_COUNT) {
+            break;
+        }
+
+        city_log(city, "Pass %s\n", handlers[j].name);
+        changed = true;
+    }
+
+    street_view_gather(&after, street);
+    street_cache_put(city->street_cache, methods, street, options, (const int *) after.options);
+    bits_reset(city->need_handle, index);
+    city_clear_delta(city, index);
+    return changed;
+}
+
+void
+city_log(const city_t *city, const char *format, ...)
+{
+    if (city->log == NULL) {
+        return;
+    }
+
+    va_list args;
+    va_start(args, format);
+    vfprintf(city->log, format, args);
+    va_end(args);
+}
+
 bool
 city_solve_step(city_t *city)
 {
-    for (int i = 0; i < 4 * city->size; i++) {
-        if (!city->need_handle[i]) {
-            continue;
-        }
+    int count = 4 * city->size;
 
-        city->need_handle[i] = false;
+    for (int i = bits_next(city->need_handle, count, 0); i >= 0;
+            i = bits_next(city->need_handle, count, i + 1)) {
+        bits_reset(city->need_handle, i);
         street_t *street = &city->streets[i];
 
-        for (size_t j = 0; j < sizeof(handlers) / sizeof(struct _handler); j++) {
-            if (handlers[j].func(street)) {
-                fprintf(stdout, "Pass %s\n", handlers[j].name);
+        if (city->street_cache != NULL) {
+            if (handle_cached(city, i)) {
+                return true;
+            }
+
+            continue;
+        }
+
+        for (size_t j = 0; j < HANDLER_COUNT; j++) {
+            if ((city->methods & handlers[j].id) != 0 && handlers[j].func(street)) {
+                city_log(city, "Pass %s\n", handlers[j].name);
                 return true;
             }
         }
+
+        /* Изменения нужны эвристикам, пока хотя бы одна из них что-то меняет. */
+        city_clear_delta(city, i);
+    }
+
+    /* Методы для всего поля работают, только когда ряды больше ничего не дают. */
+    if ((city->methods & METHOD_NOGOOD) != 0 && method_nogood(city)) {
+        city_log(city, "Pass nogood\n");
+        return true;
+    }
+
+    if ((city->methods & METHOD_FISH) != 0 && method_fish(city)) {
+        city_log(city, "Pass fish\n");
+        return true;
     }
 
     return false;
@@ -54,17 +166,129 @@ city_solve_step(city_t *city)
 bool
 city_solve(city_t *city)
 {
-    while (!city_is_solved(city)) {
-        if (!city_is_valid(city)) {
-            fprintf(stdout, "ERROR\nInvalid city.\n");
-            return false;
-        }
+    return city_solve_with(city, NULL) == SOLVE_SOLVED;
+}
 
-        if (!city_solve_step(city)) {
-            fprintf(stdout, "Bruteforce.\n");
-            return method_bruteforce(city);
-        }
+bool
+city_solve_run(city_t *city, unsigned long max_steps)
+{
+    assert(city != NULL);
+
+    if (city->search != NULL && city->search->state == SEARCH_DONE
+            && city->search->status == SOLVE_TIMEOUT) {
+        search_free(city, city->search);
+        city->search = NULL;
+    }
+
+    if (city->search == NULL) {
+        city->search = search_new(city);
+    }
+
+    for (; max_steps > 0 && city->search->state != SEARCH_DONE; max_steps--) {
+        search_step(city);
+    }
+
+    return city->search->state == SEARCH_DONE;
+}
+
+solve_status_t
+city_solve_result(const city_t *city)
+{
+    assert(city != NULL);
+    return city->search == NULL ? SOLVE_RUNNING : city->search->status;
+}
+
+/** Часы проверяются только на каждом CLOCK_PERIOD вызове city_check_budget() для цикла
+ * эвристик, узлы перебора достаточно тяжёлые, чтобы проверять часы каждый раз. */
+#define CLOCK_PERIOD 16u
+
+bool
+city_check_budget(city_t *city, bool node)
+{
+    solve_control_t *control = city->control;
+
+    if (control == NULL) {
+        return false;
+    }
+
+    if (control->expired) {
+        return true;
+    }
+
+    const solve_options_t *options = control->options;
+
+    if (node && options->max_nodes != 0 && ++control->nodes > options->max_nodes) {
+        control->expired = true;
+    }
+
+    if (solve_options_expired(options, node || ++control->ticks % CLOCK_PERIOD == 0)) {
+        control->expired = true;
+    }
+
+    return control->expired;
+}
+
+bool
+solve_options_expired(const solve_options_t *options, bool clock)
+{
+    if (options->cancel != NULL && *options->cancel != 0) {
+        return true;
+    }
+
+    if (!clock || (options->deadline.tv_sec == 0 && options->deadline.tv_nsec == 0)) {
+        return false;
+    }
+
+    struct timespec now;
+    timespec_get(&now, TIME_UTC);
+    return now.tv_sec > options->deadline.tv_sec
+           || (now.tv_sec == options->deadline.tv_sec && now.tv_nsec >= options->deadline.tv_nsec);
+}
+
+void
+solve_options_init(solve_options_t *options)
+{
+    assert(options != NULL);
+    memset(options, 0, sizeof(solve_options_t));
+    options->cancel = NULL;
+}
+
+void
+solve_options_set_timeout(solve_options_t *options, long ms)
+{
+    assert(options != NULL);
+    assert(ms >= 0);
+    timespec_get(&options->deadline, TIME_UTC);
+    options->deadline.tv_sec += ms / 1000;
+    options->deadline.tv_nsec += (ms % 1000) * 1000000L;
+
+    if (options->deadline.tv_nsec >= 1000000000L) {
+        options->deadline.tv_sec++;
+        options->deadline.tv_nsec -= 1000000000L;
+    }
+}
+
+solve_status_t
+city_solve_with(city_t *city, const solve_options_t *options)
+{
+    assert(city != NULL);
+    solve_options_t none;
+    solve_control_t control;
+
+    if (options == NULL) {
+        solve_options_init(&none);
+        options = &none;
+    }
+
+    control.options = options;
+    control.nodes = 0;
+    control.ticks = 0;
+    control.expired = false;
+    city->control = &control;
+
+    while (!city_solve_run(city, ULONG_MAX)) {
     }
 
-    return true;
+    city->control = NULL;
+    return city_solve_result(city);
 }
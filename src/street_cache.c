@@ -0,0 +1,186 @@
+/* utf-8 */
+
+/**
+ * @file
+ * @brief Кэш результатов эвристик для рядов.
+ * @details Устроен так же, как кэш решений: массив записей фиксированной ёмкости и индекс
+ * lru.h для поиска по хэшу и вытеснения давно не использованных записей.
+ *
+ * @date создан 19.10.2026
+ * @author Nick Egorrov
+ * @copyright http://www.apache.org/licenses/LICENSE-2.0
+ */
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include "skyskrapers/city.h"
+#include "skyskrapers/street.h"
+#include "skyskrapers/street_cache.h"
+#include "skyskrapers/lru.h"
+
+typedef struct _entry {
+    unsigned int methods;
+    int size;
+    int clue;
+    /** Класс стороны: 0 для верхних и правых улиц, 1 для нижних и левых. */
+    int side;
+    /** Этажи до эвристик, size элементов, и за ними этажи после эвристик, size элементов. */
+    int *data;
+    /** Размер буфера entry_t::data в элементах. */
+    int data_size;
+} entry_t;
+
+struct _street_cache {
+    /** Номера записей, индекс тот же, что в street_cache_t::entries. */
+    lru_t index;
+    entry_t *entries;
+};
+
+/** Противоположные улицы проходят по одному ряду, и часть методов обрабатывает только одну
+ * из них. */
+static int
+side_class(const street_t *street)
+{
+    return street->side > 1 ? 1 : 0;
+}
+
+static unsigned int
+hash_key(unsigned int methods, const street_t *street, const int *options)
+{
+    /* FNV-1a */
+    unsigned int hash = 2166136261u;
+    hash = (hash ^ methods) * 16777619u;
+    hash = (hash ^ (unsigned int) street->size) * 16777619u;
+    hash = (hash ^ (unsigned int) street->clue) * 16777619u;
+    hash = (hash ^ (unsigned int) side_class(street)) * 16777619u;
+
+    for (int i = 0; i < street->size; i++) {
+        hash = (hash ^ (unsigned int) options[i]) * 16777619u;
+    }
+
+    return hash;
+}
+
+/*+************************************
+ *  Поиск
+ **************************************/
+
+static int
+entry_find(const street_cache_t *cache, unsigned int hash, unsigned int methods,
+           const street_t *street, const int *options)
+{
+    for (int index = lru_first(&cache->index, hash); index != LRU_NONE;
+            index = lru_next(&cache->index, index)) {
+        const entry_t *entry = &cache->entries[index];
+
+        if (entry->methods == methods && entry->size == street->size
+                && entry->clue == street->clue && entry->side == side_class(street)
+                && memcmp(entry->data, options, (size_t) street->size * sizeof(int)) == 0) {
+            return index;
+        }
+    }
+
+    return LRU_NONE;
+}
+
+/*+************************************
+ *  PUBLIC
+ **************************************/
+
+street_cache_t *
+street_cache_new(int capacity)
+{
+    assert(capacity > 0);
+    street_cache_t *ret = malloc(sizeof(street_cache_t));
+    assert(ret != NULL);
+    lru_init(&ret->index, capacity);
+    ret->entries = calloc((size_t) capacity, sizeof(entry_t));
+    assert(ret->entries != NULL);
+    return ret;
+}
+
+void
+street_cache_free(street_cache_t *cache)
+{
+    assert(cache != NULL);
+
+    for (int i = 0; i < cache->index.count; i++) {
+        free(cache->entries[i].data);
+    }
+
+    free(cache->entries);
+    lru_destroy(&cache->index);
+    free(cache);
+}
+
+bool
+street_cache_find(street_cache_t *cache, unsigned int methods, const street_t *street,
+                  const int *options, int *result)
+{
+    assert(cache != NULL);
+    assert(street != NULL);
+    assert(options != NULL);
+    assert(result != NULL);
+    int index = entry_find(cache, hash_key(methods, street, options), methods, street, options);
+
+    if (index == LRU_NONE) {
+        cache->index.misses++;
+        return false;
+    }
+
+    cache->index.hits++;
+    lru_touch(&cache->index, index);
+    memcpy(result, cache->entries[index].data + street->size,
+           (size_t) street->size * sizeof(int));
+    return true;
+}
+
+void
+street_cache_put(street_cache_t *cache, unsigned int methods, const street_t *street,
+                 const int *options, const int *result)
+{
+    assert(cache != NULL);
+    assert(street != NULL);
+    assert(options != NULL);
+    assert(result != NULL);
+    int size = street->size;
+    unsigned int hash = hash_key(methods, street, options);
+    int index = entry_find(cache, hash, methods, street, options);
+
+    if (index != LRU_NONE) {
+        lru_touch(&cache->index, index);
+    } else {
+        index = lru_insert(&cache->index, hash);
+        entry_t *entry = &cache->entries[index];
+
+        if (entry->data_size < 2 * size) {
+            free(entry->data);
+            entry->data = malloc(2 * (size_t) size * sizeof(int));
+            assert(entry->data != NULL);
+            entry->data_size = 2 * size;
+        }
+
+        entry->methods = methods;
+        entry->size = size;
+        entry->clue = street->clue;
+        entry->side = side_class(street);
+        memcpy(entry->data, options, (size_t) size * sizeof(int));
+    }
+
+    memcpy(cache->entries[index].data + size, result, (size_t) size * sizeof(int));
+}
+
+void
+street_cache_get_stats(const street_cache_t *cache, cache_stats_t *stats)
+{
+    assert(cache != NULL);
+    lru_get_stats(&cache->index, stats);
+}
+
+void
+city_set_street_cache(city_t *city, street_cache_t *cache)
+{
+    assert(city != NULL);
+    city->street_cache = cache;
+}
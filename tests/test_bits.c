@@ -0,0 +1,75 @@
+/* utf-8 */
+
+/**
+ * @file
+ * @brief Тесты операций над битовыми масками.
+ *
+ * @date создан 19.10.2026
+ * @author Nick Egorrov
+ * @copyright http://www.apache.org/licenses/LICENSE-2.0
+ */
+
+#include <criterion/criterion.h>
+#include "skyskrapers/bits.h"
+
+Test(TestBits, Masks)
+{
+    for (unsigned int i = 1; i < 1u << 16; i++) {
+        unsigned int mask = i * 0x9e37u;
+        int count = 0, lowest = -1, highest = -1;
+
+        for (int b = 0; b < 32; b++) {
+            if ((mask & (1u << b)) != 0) {
+                count++;
+                highest = b;
+                lowest = lowest < 0 ? b : lowest;
+            }
+        }
+
+        cr_expect_eq(bits_count(mask), count, "mask=%x", mask);
+        cr_expect_eq(bits_lowest(mask), lowest, "mask=%x", mask);
+        cr_expect_eq(bits_highest(mask), highest, "mask=%x", mask);
+        cr_expect_eq(bits_height(mask), count == 1 ? lowest + 1 : 0, "mask=%x", mask);
+    }
+
+    for (int bottom = 1; bottom <= BITS_TABLE_MAX_SIZE; bottom++) {
+        for (int top = 0; top <= BITS_TABLE_MAX_SIZE; top++) {
+            unsigned int mask = 0;
+
+            for (int h = bottom; h <= top; h++) {
+                mask |= 1u << (h - 1);
+            }
+
+            cr_expect_eq(bits_range(bottom, top), mask, "bottom=%d top=%d", bottom, top);
+        }
+    }
+}
+
+Test(TestBits, Sets)
+{
+    enum { SIZE = 4 * BITS_TABLE_MAX_SIZE };
+    unsigned long set[BITS_WORDS(SIZE)] = {0};
+    bool expected[SIZE] = {false};
+
+    for (int i = 0; i < SIZE; i += 1 + i % 7) {
+        bits_set(set, i);
+        expected[i] = true;
+    }
+
+    bits_reset(set, 64);
+    expected[64] = false;
+
+    for (int from = 0; from <= SIZE; from++) {
+        int next = from;
+
+        while (next < SIZE && !expected[next]) {
+            next++;
+        }
+
+        cr_expect_eq(bits_next(set, SIZE, from), next < SIZE ? next : -1, "from=%d", from);
+    }
+
+    for (int i = 0; i < SIZE; i++) {
+        cr_expect_eq(bits_test(set, i), expected[i], "i=%d", i);
+    }
+}
@@ -0,0 +1,59 @@
+/* utf-8 */
+
+/**
+ * @file
+ * @brief Тесты табличных операций над битовыми масками.
+ * @details GCC и Clang собирают bits.h со встроенными функциями, поэтому здесь таблицы
+ * включаются явно и сравниваются с побитовым подсчётом.
+ *
+ * @date создан 19.10.2026
+ * @author Nick Egorrov
+ * @copyright http://www.apache.org/licenses/LICENSE-2.0
+ */
+
+#ifndef BITS_NO_BUILTINS
+#define BITS_NO_BUILTINS
+#endif
+#include <string.h>
+#include <criterion/criterion.h>
+#include "skyskrapers/bits.h"
+
+Test(TestBitsTable, Masks)
+{
+    for (unsigned int i = 1; i < 1u << 16; i++) {
+        unsigned int mask = i * 0x9e37u;
+        int count = 0, lowest = -1, highest = -1;
+
+        for (int b = 0; b < 32; b++) {
+            if ((mask & (1u << b)) != 0) {
+                count++;
+                highest = b;
+                lowest = lowest < 0 ? b : lowest;
+            }
+        }
+
+        cr_expect_eq(bits_count(mask), count, "mask=%x", mask);
+        cr_expect_eq(bits_lowest(mask), lowest, "mask=%x", mask);
+        cr_expect_eq(bits_highest(mask), highest, "mask=%x", mask);
+    }
+
+    for (int b = 0; b < 32; b++) {
+        cr_expect_eq(bits_height(1u << b), b + 1, "b=%d", b);
+        cr_expect_eq(bits_height((1u << b) | 1u), b == 0 ? 1 : 0, "b=%d", b);
+    }
+}
+
+Test(TestBitsTable, Sets)
+{
+    enum { SIZE = 3 * BITS_WORD_SIZE + 5 };
+    unsigned long set[BITS_WORDS(SIZE)] = {0};
+
+    for (int i = 0; i < SIZE; i++) {
+        memset(set, 0, sizeof(set));
+        bits_set(set, i);
+
+        for (int from = 0; from <= SIZE; from++) {
+            cr_expect_eq(bits_next(set, SIZE, from), from <= i ? i : -1, "i=%d from=%d", i, from);
+        }
+    }
+}
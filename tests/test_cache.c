@@ -0,0 +1,169 @@
+/* utf-8 */
+
+/**
+ * @file
+ * @brief Тесты кэша решений
+ * @details
+ *
+ * @date создан 19.10.2026
+ * @author Nick Egorrov
+ * @copyright http://www.apache.org/licenses/LICENSE-2.0
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <criterion/criterion.h>
+
+#include "skyskrapers/skyskrapers.h"
+#include "skyskrapers/city.h"
+#include "skyskrapers/tower.h"
+#include "skyskrapers/cache.h"
+#include "skyskrapers/street_cache.h"
+
+#define SIZE 6
+
+static const int clues_6x6[4 * SIZE] = {
+    3, 2, 2, 3, 2, 1,
+    1, 2, 3, 3, 2, 2,
+    5, 1, 2, 2, 4, 3,
+    3, 2, 1, 2, 2, 4
+};
+
+/** Поворот по часовой стрелке сдвигает подсказки на одну сторону. */
+static void
+rotate(int *clues)
+{
+    int tmp[4 * SIZE];
+    memcpy(tmp, clues, sizeof(tmp));
+
+    for (int i = 0; i < 4 * SIZE; i++) {
+        clues[(i + SIZE) % (4 * SIZE)] = tmp[i];
+    }
+}
+
+/** Отражение слева направо меняет направление обхода подсказок. */
+static void
+mirror(int *clues)
+{
+    int tmp[4 * SIZE];
+    memcpy(tmp, clues, sizeof(tmp));
+
+    for (int i = 0; i < 4 * SIZE; i++) {
+        clues[i] = tmp[(5 * SIZE - 1 - i) % (4 * SIZE)];
+    }
+}
+
+static bool
+check_solution(const int *clues, const int *heights)
+{
+    const int *rows[SIZE];
+
+    for (int y = 0; y < SIZE; y++) {
+        rows[y] = &heights[y * SIZE];
+    }
+
+    city_t *city = city_new(SIZE);
+    city_load_clues(city, clues);
+    city_set_heights(city, rows);
+    bool ret = city_is_solved(city);
+    city_free(city);
+    return ret;
+}
+
+Test(TestCache, Symmetries)
+{
+    cache_t *cache = cache_new(4);
+    int clues[4 * SIZE];
+    int heights[SIZE * SIZE];
+    memcpy(clues, clues_6x6, sizeof(clues));
+
+    city_t *city = city_new(SIZE);
+    city_load_clues(city, clues);
+    cr_assert(city_solve_cached(city, cache), "Puzzle not solved.");
+    city_free(city);
+
+    for (int t = 0; t < 8; t++) {
+        memset(heights, 0, sizeof(heights));
+        cr_expect(cache_find(cache, SIZE, clues, heights), "Symmetric puzzle not found.");
+        cr_expect(check_solution(clues, heights), "Wrong orientation of solution.");
+        rotate(clues);
+
+        if (t == 3) {
+            mirror(clues);
+        }
+    }
+
+    cache_stats_t stats;
+    cache_get_stats(cache, &stats);
+    cr_expect(stats.entries == 1);
+    cr_expect(stats.hits == 8);
+    cr_expect(stats.misses == 1);
+    cache_free(cache);
+}
+
+Test(TestCache, Eviction)
+{
+    cache_t *cache = cache_new(1);
+    int clues[4 * SIZE];
+    int heights[SIZE * SIZE] = {0};
+    memcpy(clues, clues_6x6, sizeof(clues));
+    cache_put(cache, SIZE, clues, heights);
+    clues[0] = 0;
+    cache_put(cache, SIZE, clues, heights);
+    cr_expect(cache_find(cache, SIZE, clues, heights));
+    cr_expect(!cache_find(cache, SIZE, clues_6x6, heights));
+
+    cache_stats_t stats;
+    cache_get_stats(cache, &stats);
+    cr_expect(stats.evictions == 1);
+    cache_free(cache);
+}
+
+Test(TestCache, Streets)
+{
+    city_t *plain = city_new(SIZE);
+    city_set_log(plain, NULL);
+    city_load_clues(plain, clues_6x6);
+    cr_assert(city_solve(plain));
+
+    street_cache_t *streets = street_cache_new(4096);
+    cache_stats_t stats;
+
+    for (int round = 0; round < 2; round++) {
+        city_t *city = city_new(SIZE);
+        city_set_log(city, NULL);
+        city_load_clues(city, clues_6x6);
+        city_set_street_cache(city, streets);
+        cr_assert(city_solve(city));
+
+        for (int i = 0; i < SIZE * SIZE; i++) {
+            cr_expect_eq(city->towers[i].height, plain->towers[i].height, "round %d i=%d", round, i);
+        }
+
+        street_cache_get_stats(streets, &stats);
+        city_free(city);
+    }
+
+    /* Второе решение проходит те же ряды. */
+    cr_expect(stats.hits > 0);
+    cr_expect(stats.entries > 0 && stats.evictions == 0);
+    street_cache_free(streets);
+
+    /* Кэш из одной записи вытесняет ряды, но решение то же. */
+    streets = street_cache_new(1);
+    city_t *city = city_new(SIZE);
+    city_set_log(city, NULL);
+    city_load_clues(city, clues_6x6);
+    city_set_street_cache(city, streets);
+    cr_assert(city_solve(city));
+    street_cache_get_stats(streets, &stats);
+    cr_expect(stats.entries == 1 && stats.evictions > 0);
+
+    for (int i = 0; i < SIZE * SIZE; i++) {
+        cr_expect_eq(city->towers[i].height, plain->towers[i].height, "i=%d", i);
+    }
+
+    city_free(city);
+    street_cache_free(streets);
+    city_free(plain);
+}
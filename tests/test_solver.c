@@ -17,6 +17,12 @@
 #include <criterion/criterion.h>
 
 #include "skyskrapers/skyskrapers.h"
+#include "skyskrapers/city.h"
+#include "skyskrapers/street.h"
+#include "skyskrapers/tower.h"
+#include "skyskrapers/methods.h"
+#include "skyskrapers/search.h"
+#include "skyskrapers/bits.h"
 
 #define MAX_PUZZLE 8u
 
@@ -250,3 +256,762 @@ Test(TestSolver, TestAll)
                 (tests[i].clock * 1000.0) / CLOCKS_PER_SEC);
     }
 }
+
+Test(TestSolver, Budget)
+{
+    struct _test t = tests[sizeof(tests) / sizeof(struct _test) - 1];
+    solve_options_t options;
+    volatile int cancel = 0;
+
+    /* Ограничение на один узел перебора прерывает решение, но оставляет верные высоты.
+     * Слабые методы нужны, чтобы головоломка не решалась без перебора. */
+    city_t *city = city_new(t.size);
+    city_set_log(city, NULL);
+    city_set_methods(city, METHOD_OBVIOUS | METHOD_EXCLUDE);
+    city_load_clues(city, t.clues);
+    solve_options_init(&options);
+    options.max_nodes = 1;
+    cr_expect(city_solve_with(city, &options) == SOLVE_TIMEOUT);
+    cr_expect(city_is_valid(city));
+    int **rows = city_get_heights(city);
+    cr_expect(equal(t.size, rows, t.expected) == 0, "Wrong state after timeout.");
+    free(rows);
+
+    /* Отмена и истёкший срок. */
+    cancel = 1;
+    solve_options_init(&options);
+    options.cancel = &cancel;
+    cr_expect(city_solve_with(city, &options) == SOLVE_TIMEOUT);
+    solve_options_init(&options);
+    solve_options_set_timeout(&options, 0);
+    cr_expect(city_solve_with(city, &options) == SOLVE_TIMEOUT);
+
+    /* Решение можно продолжить с того же состояния. */
+    cr_expect(city_solve_with(city, NULL) == SOLVE_SOLVED);
+    rows = city_get_heights(city);
+    cr_expect(equal(t.size, rows, t.expected) == 1);
+    free(rows);
+    city_free(city);
+}
+
+Test(TestSolver, Run)
+{
+    const size_t count = sizeof(tests) / sizeof(struct _test);
+    city_t *cities[sizeof(tests) / sizeof(struct _test)];
+    size_t left = count;
+
+    for (size_t i = 0; i < count; i++) {
+        cities[i] = city_new(tests[i].size);
+        city_set_log(cities[i], NULL);
+        city_load_clues(cities[i], tests[i].clues);
+    }
+
+    /* Головоломки решаются по очереди небольшими порциями, а на полпути каждая сохраняется и
+     * восстанавливается. */
+    for (int round = 0; left > 0; round++) {
+        for (size_t i = 0; i < count; i++) {
+            if (cities[i] == NULL) {
+                continue;
+            }
+
+            if (round == 40) {
+                size_t size = city_search_save(cities[i], NULL, 0);
+                unsigned char *buf = malloc(size);
+                cr_assert(city_search_save(cities[i], buf, size) == size);
+                city_free(cities[i]);
+                cities[i] = city_search_load(buf, size);
+                free(buf);
+                cr_assert(cities[i] != NULL, "Search not restored.");
+                city_set_log(cities[i], NULL);
+            }
+
+            if (city_solve_run(cities[i], 3)) {
+                cr_expect(city_solve_result(cities[i]) == SOLVE_SOLVED);
+                int **rows = city_get_heights(cities[i]);
+                cr_expect(equal(tests[i].size, rows, tests[i].expected) == 1, "%s", tests[i].title);
+                free(rows);
+                city_free(cities[i]);
+                cities[i] = NULL;
+                left--;
+            }
+        }
+    }
+}
+
+Test(TestSolver, LoadSize)
+{
+    city_t *city = city_new(tests[0].size);
+    city_set_log(city, NULL);
+    city_load_clues(city, tests[0].clues);
+    size_t size = city_search_save(city, NULL, 0);
+    unsigned char *buf = malloc(size);
+    cr_assert(city_search_save(city, buf, size) == size);
+
+    /* Размер головоломки лежит после сигнатуры и версии. */
+    const int sizes[] = {0, CITY_MIN_SIZE - 1, CITY_MAX_SIZE + 1, 30};
+
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(int); i++) {
+        buf[5] = (unsigned char) sizes[i];
+        cr_expect(city_search_load(buf, size) == NULL, "size=%d", sizes[i]);
+    }
+
+    buf[5] = (unsigned char) tests[0].size;
+    city_t *loaded = city_search_load(buf, size);
+    cr_expect(loaded != NULL);
+    city_free(loaded);
+    free(buf);
+    city_free(city);
+}
+
+Test(TestSolver, ImpossibleClues)
+{
+    /* Сумма противоположных подсказок больше размера плюс один. */
+    int sum[16] = {
+        4, 0, 0, 0,
+        0, 0, 0, 0,
+        0, 0, 0, 4,
+        0, 0, 0, 0
+    };
+    /* Колонка возрастает сверху вниз, а строка требует самое высокое здание в углу. */
+    int cross[16] = {
+        4, 0, 0, 0,
+        0, 0, 0, 0,
+        0, 0, 0, 0,
+        0, 0, 0, 1
+    };
+    int *clues[] = {sum, cross};
+
+    for (size_t i = 0; i < sizeof(clues) / sizeof(clues[0]); i++) {
+        city_t *city = city_new(4);
+        city_set_log(city, NULL);
+        cr_expect(!city_load_clues(city, clues[i]));
+        cr_expect(!city_is_valid(city));
+        cr_expect(city_solve_with(city, NULL) == SOLVE_UNSOLVABLE);
+        city_free(city);
+    }
+}
+
+Test(TestSolver, Subset)
+{
+    int clues[24] = {0};
+    city_t *city = city_new(6);
+    city_load_clues(city, clues);
+
+    /* Открытая пара: первые два здания допускают только высоты 1 и 2. */
+    street_t *street = &city->streets[0];
+    tower_and_options(street_get_tower(street, 0), 0x03);
+    tower_and_options(street_get_tower(street, 1), 0x03);
+    cr_expect(method_subset(street));
+
+    for (int k = 2; k < 6; k++) {
+        cr_expect_eq(tower_get_options(street_get_tower(street, k)), 0x3c);
+    }
+
+    cr_expect(!method_subset(street));
+
+    /* Скрытая пара: высоты 5 и 6 возможны только в третьем и четвёртом зданиях. */
+    street = &city->streets[7];
+
+    for (int k = 0; k < 6; k++) {
+        if (k != 2 && k != 3) {
+            tower_and_options(street_get_tower(street, k), 0x0f);
+        }
+    }
+
+    cr_expect(method_subset(street));
+    cr_expect_eq(tower_get_options(street_get_tower(street, 2)), 0x30);
+    cr_expect_eq(tower_get_options(street_get_tower(street, 3)), 0x30);
+    city_free(city);
+}
+
+Test(TestSolver, AllDiff)
+{
+    int clues[16] = {0};
+    city_t *city = city_new(4);
+    city_load_clues(city, clues);
+
+    /* Высоты 1 и 2 заняты первыми двумя зданиями, значит третье - 3, а четвёртое - 4. */
+    street_t *street = &city->streets[0];
+    tower_and_options(street_get_tower(street, 0), 0x03);
+    tower_and_options(street_get_tower(street, 1), 0x03);
+    tower_and_options(street_get_tower(street, 2), 0x07);
+    cr_expect(method_alldiff(street));
+    cr_expect_eq(tower_get_height(street_get_tower(street, 2)), 3);
+    cr_expect_eq(tower_get_height(street_get_tower(street, 3)), 4);
+    cr_expect(!method_alldiff(street));
+
+    /* Три здания на две высоты. */
+    street = &city->streets[4];
+
+    for (int k = 0; k < 3; k++) {
+        tower_and_options(street_get_tower(street, k), 0x0c);
+    }
+
+    cr_expect(method_alldiff(street));
+    cr_expect(!city_is_valid(city));
+    city_free(city);
+
+    /* Головоломки решаются с фильтром вместо исключения и подмножеств. */
+    for (size_t i = 0; i < sizeof(tests) / sizeof(struct _test); i++) {
+        city = city_new(tests[i].size);
+        city_set_log(city, NULL);
+        unsigned int methods = METHOD_DEFAULT | METHOD_ALLDIFF;
+        city_set_methods(city, methods & ~(unsigned int) (METHOD_EXCLUDE | METHOD_SUBSET));
+        city_load_clues(city, tests[i].clues);
+        cr_expect(city_solve(city));
+        int **rows = city_get_heights(city);
+        cr_expect(equal(tests[i].size, rows, tests[i].expected) > 0, "%s", tests[i].title);
+        free(rows);
+        city_free(city);
+    }
+}
+
+/** Высоты, которые входят хотя бы в одну перестановку с видимостью @p clue. */
+static void
+support(int size, int clue, const int *options, int *heights, int k, int *result)
+{
+    if (k == size) {
+        int visible = 0, top = 0;
+
+        for (int i = 0; i < size; i++) {
+            if (heights[i] > top) {
+                top = heights[i];
+                visible++;
+            }
+        }
+
+        for (int i = 0; visible == clue && i < size; i++) {
+            result[i] |= 1 << (heights[i] - 1);
+        }
+
+        return;
+    }
+
+    for (int h = 1; h <= size; h++) {
+        bool used = false;
+
+        for (int i = 0; i < k; i++) {
+            used = used || heights[i] == h;
+        }
+
+        if (!used && (options[k] & (1 << (h - 1))) != 0) {
+            heights[k] = h;
+            support(size, clue, options, heights, k + 1, result);
+        }
+    }
+}
+
+Test(TestSolver, Visibility)
+{
+    const int size = 5;
+    int clues[20] = {0};
+    unsigned int seed = 1;
+
+    for (int round = 0; round < 500; round++) {
+        city_t *city = city_new(size);
+        clues[0] = round % size + 1;
+        city_set_clues(city, clues);
+        street_t *street = &city->streets[0];
+        int options[5], heights[5], result[5] = {0};
+
+        for (int k = 0; k < size; k++) {
+            tower_and_options(street_get_tower(street, k), rand_r(&seed) & city->mask);
+            options[k] = tower_get_options(street_get_tower(street, k));
+        }
+
+        support(size, clues[0], options, heights, 0, result);
+        method_visibility(street);
+
+        for (int k = 0; k < size; k++) {
+            int kept = tower_get_options(street_get_tower(street, k));
+            cr_expect_eq(kept & result[k], result[k], "Supported height removed.");
+            cr_expect_eq(kept & ~options[k], 0);
+        }
+
+        city_free(city);
+    }
+
+    /* Подсказка равная размеру задаёт лестницу. */
+    city_t *city = city_new(size);
+    clues[0] = size;
+    city_set_clues(city, clues);
+    method_visibility(&city->streets[0]);
+
+    for (int k = 0; k < size; k++) {
+        cr_expect_eq(tower_get_height(street_get_tower(&city->streets[0], k)), k + 1);
+    }
+
+    city_free(city);
+}
+
+Test(TestSolver, Fish)
+{
+    int clues[16] = {0};
+    city_t *city = city_new(4);
+    city_set_log(city, NULL);
+    city_load_clues(city, clues);
+
+    /* В строках 0 и 2 высота 1 возможна только в столбцах 1 и 3. */
+    for (int y = 0; y < 4; y += 2) {
+        for (int x = 0; x < 4; x += 2) {
+            tower_and_options(&city->towers[x + y * 4], ~1);
+        }
+    }
+
+    cr_expect(method_fish(city));
+
+    for (int y = 0; y < 4; y++) {
+        for (int x = 0; x < 4; x++) {
+            bool allowed = (city->towers[x + y * 4].options & 1) != 0;
+            cr_expect_eq(allowed, (x % 2) != (y % 2), "x=%d y=%d", x, y);
+        }
+    }
+
+    cr_expect(!method_fish(city));
+    city_free(city);
+}
+
+Test(TestSolver, Probe)
+{
+    solve_options_t options;
+    unsigned long limits[] = {0, 1};
+    int threads[] = {1, 4};
+
+    for (size_t n = 0; n < 2; n++) {
+        for (size_t i = 0; i < sizeof(tests) / sizeof(struct _test); i++) {
+            city_t *city = city_new(tests[i].size);
+            city_set_log(city, NULL);
+            city_set_methods(city, METHOD_DEFAULT | METHOD_PROBE);
+            city_load_clues(city, tests[i].clues);
+            solve_options_init(&options);
+            options.probe_limit = limits[n];
+            options.probe_threads = threads[n];
+            cr_expect(city_solve_with(city, &options) == SOLVE_SOLVED, "%s", tests[i].title);
+            int **rows = city_get_heights(city);
+            cr_expect(equal(tests[i].size, rows, tests[i].expected) > 0, "%s", tests[i].title);
+            free(rows);
+            city_free(city);
+        }
+    }
+}
+
+Test(TestSolver, HiddenTowers)
+{
+    /* Недостроенное второе здание может быть высоты 6 и закрыть все следующие. */
+    int clues[24] = {2};
+    int row[6] = {1, 0, 3, 2, 4, 5};
+    city_t *city = city_new(6);
+    city_set_clues(city, clues);
+    street_t *street = &city->streets[0];
+
+    for (int k = 0; k < 6; k++) {
+        tower_set_height(street_get_tower(street, k), row[k]);
+    }
+
+    cr_expect(city_is_valid(city));
+    tower_set_options(street_get_tower(street, 1), 0x20);
+    cr_expect(city_is_valid(city));
+    city_free(city);
+}
+
+Test(TestSolver, Nogood)
+{
+    int clues[16] = {0};
+    city_t *city = city_new(4);
+    city_set_log(city, NULL);
+    city_load_clues(city, clues);
+    city->search = search_new(city);
+    city->search->nogoods = memory_alloc(&city->memory, NOGOOD_CAPACITY * sizeof(nogood_t));
+    city->search->nogood_count = 1;
+    nogood_t *nogood = &city->search->nogoods[0];
+    *nogood = (nogood_t) {2, {0, 5}, {1, 2}};
+
+    /* Одно решение сочетания выполнено, второе исключается. */
+    cr_expect(!method_nogood(city));
+    tower_set_height(&city->towers[0], 1);
+    cr_expect(method_nogood(city));
+    cr_expect_eq(city->towers[5].options, 0x0d);
+    cr_expect(!method_nogood(city));
+    city_free(city);
+
+    /* Перебор с запоминанием сочетаний находит те же решения. */
+    for (size_t i = 0; i < 7; i++) {
+        city = city_new(tests[i].size);
+        city_set_log(city, NULL);
+        city_set_methods(city, METHOD_OBVIOUS | METHOD_EXCLUDE | METHOD_NOGOOD);
+        city_load_clues(city, tests[i].clues);
+        cr_expect(city_solve(city), "%s", tests[i].title);
+        int **rows = city_get_heights(city);
+        cr_expect(equal(tests[i].size, rows, tests[i].expected) > 0, "%s", tests[i].title);
+        free(rows);
+        city_free(city);
+    }
+}
+
+static void
+expect_boards(const city_t *city)
+{
+    int sz = city->size;
+
+    for (int h = 0; h < sz; h++) {
+        for (int y = 0; y < sz; y++) {
+            for (int x = 0; x < sz; x++) {
+                bool allowed = (city->towers[x + y * sz].options & (1 << h)) != 0;
+                cr_expect_eq(allowed, (city->rows[h * sz + y] & (1u << x)) != 0,
+                             "row h=%d x=%d y=%d", h + 1, x, y);
+                cr_expect_eq(allowed, (city->cols[h * sz + x] & (1u << y)) != 0,
+                             "col h=%d x=%d y=%d", h + 1, x, y);
+            }
+        }
+    }
+}
+
+Test(TestSolver, Boards)
+{
+    for (size_t i = 0; i < sizeof(tests) / sizeof(struct _test); i++) {
+        city_t *city = city_new(tests[i].size);
+        city_set_log(city, NULL);
+        city_load_clues(city, tests[i].clues);
+        expect_boards(city);
+
+        while (city_solve_step(city)) {
+            expect_boards(city);
+        }
+
+        city_t *copy = city_copy(0, city);
+        expect_boards(copy);
+        city_solve(city);
+        expect_boards(city);
+        city_free(copy);
+        city_free(city);
+    }
+}
+
+Test(TestSolver, Trail)
+{
+    struct _test t = tests[sizeof(tests) / sizeof(struct _test) - 1];
+    city_t *city = city_new(t.size);
+    city_set_log(city, NULL);
+    city_load_clues(city, t.clues);
+    city_t *before = city_copy(0, city);
+    trail_t trail = {NULL, 0, 0};
+    city->trail = &trail;
+    tower_set_height(&city->towers[0], 1);
+
+    while (city_is_valid(city) && city_solve_step(city)) {
+    }
+
+    cr_expect(trail.size > 0);
+    city_trail_restore(city, &trail, 0);
+    city->trail = NULL;
+
+    for (int i = 0; i < t.size * t.size; i++) {
+        cr_expect_eq(city->towers[i].options, before->towers[i].options, "i=%d", i);
+        cr_expect_eq(city->towers[i].height, before->towers[i].height, "i=%d", i);
+    }
+
+    expect_boards(city);
+    cr_expect(city_is_valid(city));
+    city_trail_free(city, &trail);
+    city_free(before);
+    city_free(city);
+}
+
+static void
+expect_counters(const city_t *city)
+{
+    int unsolved = 0, empty = 0, invalid = 0, outdated = 0;
+
+    for (int i = 0; i < city->size * city->size; i++) {
+        unsolved += city->towers[i].height == 0;
+        empty += city->towers[i].options == 0;
+    }
+
+    for (int i = 0; i < 4 * city->size; i++) {
+        outdated += bits_test(city->need_update, i);
+        invalid += !bits_test(city->need_update, i) && !city->streets[i].valid;
+    }
+
+    cr_expect_eq(city->unsolved, unsolved);
+    cr_expect_eq(city->empty, empty);
+    cr_expect_eq(city->invalid, invalid);
+    cr_expect_eq(city->outdated, outdated);
+}
+
+Test(TestSolver, Counters)
+{
+    for (size_t i = 0; i < sizeof(tests) / sizeof(struct _test); i++) {
+        city_t *city = city_new(tests[i].size);
+        city_set_log(city, NULL);
+        city_load_clues(city, tests[i].clues);
+        expect_counters(city);
+        trail_t trail = {NULL, 0, 0};
+        city->trail = &trail;
+
+        while (city_is_valid(city) && city_solve_step(city)) {
+            expect_counters(city);
+        }
+
+        city_trail_restore(city, &trail, 0);
+        city->trail = NULL;
+        expect_counters(city);
+        city_t *copy = city_copy(0, city);
+        expect_counters(copy);
+        cr_expect(city_solve(copy));
+        expect_counters(copy);
+        cr_expect_eq(copy->unsolved, 0);
+        cr_expect(city_is_solved(copy));
+
+        tower_set_options(&city->towers[0], 0);
+        cr_expect_eq(city->empty, 1);
+        cr_expect(!city_is_valid(city));
+        expect_counters(city);
+        city_trail_free(city, &trail);
+        city_free(copy);
+        city_free(city);
+    }
+}
+
+Test(TestSolver, Delta)
+{
+    struct _test t = tests[sizeof(tests) / sizeof(struct _test) - 1];
+    int sz = t.size;
+    city_t *city = city_new(sz);
+    city_set_log(city, NULL);
+    city_load_clues(city, t.clues);
+    cr_expect_eq(street_get_fixed(&city->streets[0]), (1u << sz) - 1u);
+
+    while (city_solve_step(city)) {
+    }
+
+    for (int i = 0; i < 4 * sz; i++) {
+        cr_expect_eq(street_get_fixed(&city->streets[i]), 0, "i=%d", i);
+    }
+
+    int x = 0, y = 0;
+
+    while (city->towers[x + y * sz].height != 0) {
+        x = (x + 1) % sz;
+        y += x == 0;
+    }
+
+    tower_t *tower = &city->towers[x + y * sz];
+    int options = tower->options;
+    int height = bits_lowest((unsigned int) options) + 1;
+    tower_set_height(tower, height);
+    int streets[4] = {x, sz + y, 3 * sz - x - 1, 4 * sz - y - 1};
+
+    for (int j = 0; j < 4; j++) {
+        street_t *street = &city->streets[streets[j]];
+        unsigned int fixed = street_get_fixed(street);
+        cr_expect(bits_is_single(fixed), "street=%d", streets[j]);
+        cr_expect_eq(street_get_tower(street, bits_lowest(fixed)), tower);
+        cr_expect_eq(street_get_removed(street, bits_lowest(fixed)),
+                     (unsigned int) (options & ~(1 << (height - 1))));
+    }
+
+    city_clear_delta(city, x);
+    cr_expect_eq(street_get_fixed(&city->streets[x]), 0);
+    city_free(city);
+}
+
+Test(TestSolver, Snapshot)
+{
+    struct _test t = tests[sizeof(tests) / sizeof(struct _test) - 1];
+    int sz = t.size;
+    city_t *city = city_new(sz);
+    city_set_log(city, NULL);
+    city_load_clues(city, t.clues);
+
+    while (city_solve_step(city)) {
+    }
+
+    city_t *before = city_copy(0, city);
+    snapshot_t *snapshot = city_snapshot_new(city);
+    city_snapshot_take(city, snapshot);
+
+    for (int i = 0; i < sz * sz; i++) {
+        tower_t *tower = &city->towers[i];
+
+        if (tower->height != 0) {
+            continue;
+        }
+
+        tower_set_height(tower, bits_highest((unsigned int) tower->options) + 1);
+
+        while (city_is_valid(city) && city_solve_step(city)) {
+        }
+
+        city_snapshot_restore(city);
+
+        for (int k = 0; k < sz * sz; k++) {
+            cr_expect_eq(city->towers[k].options, before->towers[k].options, "k=%d", k);
+            cr_expect_eq(city->towers[k].height, before->towers[k].height, "k=%d", k);
+        }
+
+        for (int k = 0; k < 4 * sz; k++) {
+            cr_expect_eq(city->streets[k].valid, before->streets[k].valid, "k=%d", k);
+            cr_expect_eq(city->streets[k].visible, before->streets[k].visible, "k=%d", k);
+            cr_expect_eq(bits_test(city->need_handle, k), bits_test(before->need_handle, k));
+            cr_expect_eq(street_get_fixed(&city->streets[k]), street_get_fixed(&before->streets[k]));
+        }
+
+        expect_boards(city);
+        expect_counters(city);
+    }
+
+    city->snapshot = NULL;
+    city_snapshot_free(snapshot);
+    city_free(before);
+    city_free(city);
+}
+
+Test(TestSolver, StreetView)
+{
+    struct _test t = tests[sizeof(tests) / sizeof(struct _test) - 1];
+    int sz = t.size;
+    city_t *city = city_new(sz);
+    city_set_log(city, NULL);
+    city_load_clues(city, t.clues);
+    street_view_t view;
+
+    for (int i = 0; i < 4 * sz; i++) {
+        street_t *street = &city->streets[i];
+        street_view_gather(&view, street);
+        cr_expect_eq(view.size, sz);
+
+        for (int k = 0; k < sz; k++) {
+            tower_t *tower = street_get_tower(street, k);
+            cr_expect_eq(view.towers[k], tower, "i=%d k=%d", i, k);
+            cr_expect_eq(view.options[k], (unsigned int) tower->options, "i=%d k=%d", i, k);
+            cr_expect_eq(view.heights[k], tower->height, "i=%d k=%d", i, k);
+        }
+
+        cr_expect(!street_view_scatter(&view));
+    }
+
+    street_t *street = &city->streets[sz + 1];
+    street_view_gather(&view, street);
+    int k = 0;
+
+    while (view.heights[k] != 0) {
+        k++;
+    }
+
+    view.options[k] = 1u << bits_lowest(view.options[k]);
+    cr_expect(street_view_scatter(&view));
+    cr_expect_eq(street_get_tower(street, k)->height, view.heights[k]);
+    cr_expect_neq(view.heights[k], 0);
+    cr_expect(!street_view_scatter(&view));
+    expect_boards(city);
+    city_free(city);
+}
+
+Test(TestSolver, ValueOrder)
+{
+    for (int order = 0; order < ORDER_COUNT; order++) {
+        for (size_t i = 0; i < sizeof(tests) / sizeof(struct _test); i++) {
+            city_t *city = city_new(tests[i].size);
+            city_set_log(city, NULL);
+            city_set_value_order(city, order);
+            city_load_clues(city, tests[i].clues);
+            cr_expect_eq(city_solve_with(city, NULL), SOLVE_SOLVED, "order=%d i=%zu", order, i);
+            int **rows = city_get_heights(city);
+            cr_expect(equal(tests[i].size, rows, tests[i].expected) > 0, "order=%d i=%zu", order, i);
+            free(rows);
+            city_free(city);
+        }
+    }
+}
+
+Test(TestSolver, VisibilitySupport)
+{
+    int sz = 5;
+    city_t *city = city_new(sz);
+    city_set_log(city, NULL);
+    street_t *street = &city->streets[0];
+    street->clue = sz;
+    double support[5];
+
+    /* При подсказке N ряд возрастает, других расстановок нет. */
+    for (int k = 0; k < sz; k++) {
+        method_visibility_support(street, k, support);
+
+        for (int h = 1; h <= sz; h++) {
+            cr_expect_eq(support[h - 1], h == k + 1 ? 1.0 : 0.0, "k=%d h=%d", k, h);
+        }
+    }
+
+    /* При подсказке 1 первое здание самое высокое, остальные N - 1 любые ниже него. */
+    street->clue = 1;
+    method_visibility_support(street, 0, support);
+    cr_expect_eq(support[sz - 1], 4.0 * 4 * 4 * 4);
+    cr_expect_eq(support[0], 0.0);
+    city_free(city);
+}
+
+/** Распределитель поверх malloc(), который считает выделенные байты и блоки. */
+struct _counting {
+    size_t bytes;
+    long blocks;
+    bool bad_size;
+};
+
+static void *
+counting_alloc(void *context, size_t size)
+{
+    struct _counting *counting = context;
+    size_t *block = malloc(size + sizeof(max_align_t));
+    *block = size;
+    counting->bytes += size;
+    counting->blocks++;
+    return (char *) block + sizeof(max_align_t);
+}
+
+static void
+counting_release(void *context, void *ptr, size_t size)
+{
+    struct _counting *counting = context;
+    size_t *block = (size_t *) (void *) ((char *) ptr - sizeof(max_align_t));
+    counting->bad_size |= *block != size;
+    counting->bytes -= size;
+    counting->blocks--;
+    free(block);
+}
+
+Test(TestSolver, Allocator)
+{
+    struct _counting counting = {0, 0, false};
+    allocator_t allocator = {counting_alloc, counting_release, &counting};
+    memory_stats_t stats;
+
+    for (size_t i = 0; i < sizeof(tests) / sizeof(struct _test); i++) {
+        city_t *city = city_new_with_allocator(tests[i].size, &allocator);
+        city_set_log(city, NULL);
+        city_set_value_order(city, ORDER_SUPPORT);
+        city_get_memory_stats(city, &stats);
+        cr_expect_eq(stats.current, counting.bytes, "i=%zu", i);
+        city_load_clues(city, tests[i].clues);
+        city_t *copy = city_copy(0, city);
+        cr_expect(city_solve(city), "i=%zu", i);
+        int **rows = city_get_heights(city);
+        cr_expect(equal(tests[i].size, rows, tests[i].expected) > 0, "i=%zu", i);
+        free(rows);
+
+        /* Копия берёт память у того же распределителя, но считает её отдельно. */
+        memory_stats_t copied;
+        city_get_memory_stats(city, &stats);
+        city_get_memory_stats(copy, &copied);
+        cr_expect(stats.peak >= stats.current);
+        cr_expect(stats.peak > copied.peak, "i=%zu", i);
+        cr_expect_eq(stats.current + copied.current, counting.bytes, "i=%zu", i);
+        cr_expect_eq(stats.allocs - stats.frees + copied.allocs - copied.frees,
+                     (unsigned long long) counting.blocks, "i=%zu", i);
+        city_free(copy);
+        city_free(city);
+        cr_expect_eq(counting.bytes, 0, "i=%zu", i);
+        cr_expect_eq(counting.blocks, 0, "i=%zu", i);
+    }
+
+    cr_expect(!counting.bad_size);
+}
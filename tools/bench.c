@@ -0,0 +1,380 @@
+/* utf-8 */
+
+/**
+ * @file
+ * @brief Сравнение методов решения.
+ * @details Для случайного латинского квадрата открывается часть высот, после чего цикл
+ * эвристик с каждым набором методов выполняется до неподвижной точки. Печатается количество
+ * исключённых этажей, затраченное время и исключённые этажи на микросекунду.
+ *
+ * С ключом -o сравниваются порядки высот перебора: каждая головоломка набора решается до
+ * первого решения с каждым порядком, печатается количество решённых, общее и худшее время.
+ *
+ * С ключом -c головоломки набора решаются порядком по умолчанию, а вокруг каждой снимаются
+ * аппаратные счётчики процессора (perf.h). Печатаются суммы по размерам головоломок, для
+ * недоступных счётчиков - прочерк.
+ *
+ * @verbatim
+   skyskrapers-bench [-n size] [-p percent] [-r rounds] [-s seed]
+   skyskrapers-bench -o [-f corpus] [-T timeout]
+   skyskrapers-bench -c [-f corpus] [-T timeout]
+
+   -n  размер головоломки, от CITY_MIN_SIZE до CITY_MAX_SIZE
+   -p  процент открытых высот
+   -r  количество случайных квадратов
+   -s  начальное значение генератора
+   -o  сравнить порядки высот перебора
+   -c  счётчики процессора по размерам головоломок
+   -f  файл набора головоломок, по умолчанию встроенный набор
+   -T  предел времени на головоломку в миллисекундах
+   @endverbatim
+ *
+ * @date создан 19.10.2026
+ * @author Nick Egorrov
+ * @copyright http://www.apache.org/licenses/LICENSE-2.0
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "skyskrapers/skyskrapers.h"
+#include "skyskrapers/city.h"
+#include "skyskrapers/tower.h"
+#include "corpus.h"
+#include "perf.h"
+
+static const struct _method_set {
+    const char *name;
+    unsigned int methods;
+} sets[] = {
+    {"obvious+exclude", METHOD_OBVIOUS | METHOD_EXCLUDE},
+    {"obvious+exclude+subset", METHOD_OBVIOUS | METHOD_EXCLUDE | METHOD_SUBSET},
+    {"alldiff", METHOD_ALLDIFF}
+};
+
+#define SET_COUNT (sizeof(sets) / sizeof(sets[0]))
+
+static const char *order_names[ORDER_COUNT] = {"descending", "lcv", "support"};
+
+static double
+now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec * 1e9 + (double) ts.tv_nsec;
+}
+
+static void
+shuffle(int *array, int count, unsigned int *seed)
+{
+    for (int i = count - 1; i > 0; i--) {
+        int j = rand_r(seed) % (i + 1);
+        int tmp = array[i];
+        array[i] = array[j];
+        array[j] = tmp;
+    }
+}
+
+/** Латинский квадрат из циклического перестановками строк, столбцов и высот. */
+static void
+make_square(int size, int *square, unsigned int *seed)
+{
+    int rows[CITY_MAX_SIZE], cols[CITY_MAX_SIZE], heights[CITY_MAX_SIZE];
+
+    for (int i = 0; i < size; i++) {
+        rows[i] = cols[i] = heights[i] = i;
+    }
+
+    shuffle(rows, size, seed);
+    shuffle(cols, size, seed);
+    shuffle(heights, size, seed);
+
+    for (int y = 0; y < size; y++) {
+        for (int x = 0; x < size; x++) {
+            square[y * size + x] = heights[(rows[y] + cols[x]) % size] + 1;
+        }
+    }
+}
+
+static int
+count_options(const city_t *city)
+{
+    int ret = 0;
+
+    for (int i = 0; i < city->size * city->size; i++) {
+        for (int m = city->towers[i].options; m != 0; m &= m - 1) {
+            ret++;
+        }
+    }
+
+    return ret;
+}
+
+/** Время до первого решения набора с каждым порядком высот. */
+static int
+bench_orders(const char *path, long timeout)
+{
+    corpus_t *corpus = path != NULL ? corpus_load(path) : corpus_builtin();
+
+    if (corpus == NULL || corpus->count == 0) {
+        fprintf(stderr, "Empty corpus\n");
+        return 1;
+    }
+
+    printf("puzzles %d, timeout %ld ms\n", corpus->count, timeout);
+    printf("%-12s %8s %12s %12s\n", "order", "solved", "total ms", "worst ms");
+
+    for (int order = 0; order < ORDER_COUNT; order++) {
+        double total = 0, worst = 0;
+        int solved = 0;
+
+        for (int i = 0; i < corpus->count; i++) {
+            city_t *city = city_new(corpus->puzzles[i].size);
+            city_set_log(city, NULL);
+            city_set_value_order(city, order);
+            solve_options_t options;
+            solve_options_init(&options);
+            solve_options_set_timeout(&options, timeout);
+            double start = now_ns();
+            bool loaded = city_load_clues(city, corpus->puzzles[i].clues);
+            solved += loaded && city_solve_with(city, &options) == SOLVE_SOLVED;
+            double ms = (now_ns() - start) / 1e6;
+            total += ms;
+            worst = ms > worst ? ms : worst;
+            city_free(city);
+        }
+
+        printf("%-12s %8d %12.3f %12.3f\n", order_names[order], solved, total, worst);
+    }
+
+    corpus_free(corpus);
+    return 0;
+}
+
+/** Суммы по головоломкам одного размера. */
+typedef struct _size_stats {
+    int count;
+    int solved;
+    double ms;
+    long long values[PERF_COUNTERS];
+} size_stats_t;
+
+static void
+print_value(long long value)
+{
+    if (value < 0) {
+        printf(" %12s", "-");
+    } else {
+        printf(" %12lld", value);
+    }
+}
+
+/** Счётчики процессора для набора по размерам головоломок. */
+static int
+bench_counters(const char *path, long timeout)
+{
+    corpus_t *corpus = path != NULL ? corpus_load(path) : corpus_builtin();
+
+    if (corpus == NULL || corpus->count == 0) {
+        fprintf(stderr, "Empty corpus\n");
+        return 1;
+    }
+
+    perf_t perf;
+
+    if (perf_open(&perf) == 0) {
+        fprintf(stderr, "Hardware counters are unavailable, see perf_event_paranoid\n");
+    }
+
+    size_stats_t stats[CITY_MAX_SIZE + 1] = {0};
+
+    for (int i = 0; i < corpus->count; i++) {
+        size_stats_t *size = &stats[corpus->puzzles[i].size];
+        city_t *city = city_new(corpus->puzzles[i].size);
+        city_set_log(city, NULL);
+        solve_options_t options;
+        solve_options_init(&options);
+        solve_options_set_timeout(&options, timeout);
+        long long values[PERF_COUNTERS];
+        double start = now_ns();
+        perf_start(&perf);
+        bool loaded = city_load_clues(city, corpus->puzzles[i].clues);
+        bool solved = loaded && city_solve_with(city, &options) == SOLVE_SOLVED;
+        perf_stop(&perf, values);
+        size->ms += (now_ns() - start) / 1e6;
+        size->solved += solved;
+
+        for (int c = 0; c < PERF_COUNTERS; c++) {
+            /* Сумма без одного из значений ничего не говорит. */
+            if (size->count > 0 && size->values[c] < 0) {
+                continue;
+            }
+
+            size->values[c] = values[c] < 0 ? -1 : size->values[c] + values[c];
+        }
+
+        size->count++;
+        city_free(city);
+    }
+
+    printf("puzzles %d, timeout %ld ms\n", corpus->count, timeout);
+    printf("%4s %7s %7s %10s", "size", "puzzles", "solved", "ms");
+
+    for (int c = 0; c < PERF_COUNTERS; c++) {
+        printf(" %12s", perf_names[c]);
+    }
+
+    printf(" %6s\n", "IPC");
+
+    for (int n = CITY_MIN_SIZE; n <= CITY_MAX_SIZE; n++) {
+        const size_stats_t *size = &stats[n];
+
+        if (size->count == 0) {
+            continue;
+        }
+
+        printf("%4d %7d %7d %10.3f", n, size->count, size->solved, size->ms);
+
+        for (int c = 0; c < PERF_COUNTERS; c++) {
+            print_value(size->values[c]);
+        }
+
+        if (size->values[PERF_CYCLES] > 0 && size->values[PERF_INSTRUCTIONS] >= 0) {
+            printf(" %6.2f\n", (double) size->values[PERF_INSTRUCTIONS]
+                   / (double) size->values[PERF_CYCLES]);
+        } else {
+            printf(" %6s\n", "-");
+        }
+    }
+
+    perf_close(&perf);
+    corpus_free(corpus);
+    return 0;
+}
+
+static void
+usage(const char *name)
+{
+    fprintf(stderr, "Usage: %s [-n size] [-p percent] [-r rounds] [-s seed]\n"
+            "       %s -o [-f corpus] [-T timeout]\n"
+            "       %s -c [-f corpus] [-T timeout]\n", name, name, name);
+}
+
+int
+main(int argc, char **argv)
+{
+    int size = 16;
+    int percent = 40;
+    int rounds = 100;
+    unsigned int seed = 1;
+    bool orders = false;
+    bool counters = false;
+    const char *corpus_path = NULL;
+    long timeout = 10000;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:p:r:s:ocf:T:h")) != -1) {
+        switch (opt) {
+        case 'n':
+            size = atoi(optarg);
+            break;
+
+        case 'p':
+            percent = atoi(optarg);
+            break;
+
+        case 'r':
+            rounds = atoi(optarg);
+            break;
+
+        case 's':
+            seed = (unsigned int) strtoul(optarg, NULL, 10);
+            break;
+
+        case 'o':
+            orders = true;
+            break;
+
+        case 'c':
+            counters = true;
+            break;
+
+        case 'f':
+            corpus_path = optarg;
+            break;
+
+        case 'T':
+            timeout = atol(optarg);
+            break;
+
+        default:
+            usage(argv[0]);
+            return opt == 'h' ? 0 : 1;
+        }
+    }
+
+    if (orders && !counters && timeout > 0) {
+        return bench_orders(corpus_path, timeout);
+    }
+
+    if (counters && !orders && timeout > 0) {
+        return bench_counters(corpus_path, timeout);
+    }
+
+    if (orders || counters || size < CITY_MIN_SIZE || size > CITY_MAX_SIZE || percent < 0
+            || percent > 100 || rounds < 1) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    int clues[4 * CITY_MAX_SIZE] = {0};
+    int square[CITY_MAX_SIZE * CITY_MAX_SIZE];
+    double elapsed[SET_COUNT] = {0};
+    long removed[SET_COUNT] = {0};
+    long solved[SET_COUNT] = {0};
+
+    for (int r = 0; r < rounds; r++) {
+        make_square(size, square, &seed);
+        city_t *given = city_new(size);
+        city_set_log(given, NULL);
+        city_load_clues(given, clues);
+
+        for (int i = 0; i < size * size; i++) {
+            if (rand_r(&seed) % 100 < percent) {
+                tower_set_height(&given->towers[i], square[i]);
+            }
+        }
+
+        for (size_t s = 0; s < SET_COUNT; s++) {
+            city_t *city = city_copy(0, given);
+            city_set_methods(city, sets[s].methods);
+            int before = count_options(city);
+            double start = now_ns();
+
+            while (city_solve_step(city)) {
+            }
+
+            elapsed[s] += now_ns() - start;
+            removed[s] += before - count_options(city);
+            solved[s] += city_is_solved(city);
+            city_free(city);
+        }
+
+        city_free(given);
+    }
+
+    printf("size %d, given %d%%, rounds %d\n", size, percent, rounds);
+    printf("%-24s %10s %10s %12s %8s\n", "methods", "removed", "time us", "removed/us",
+           "solved");
+
+    for (size_t s = 0; s < SET_COUNT; s++) {
+        double us = elapsed[s] / 1e3;
+        printf("%-24s %10ld %10.0f %12.3f %8ld\n", sets[s].name, removed[s], us,
+               us > 0 ? (double) removed[s] / us : 0.0, solved[s]);
+    }
+
+    return 0;
+}
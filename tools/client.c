@@ -0,0 +1,115 @@
+/* utf-8 */
+
+/**
+ * @file
+ * @brief Клиент сервера решений.
+ * @details
+ *
+ * @date создан 19.10.2026
+ * @author Nick Egorrov
+ * @copyright http://www.apache.org/licenses/LICENSE-2.0
+ */
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "skyskrapers/protocol.h"
+#include "skyskrapers/client.h"
+#include "frame.h"
+
+struct _client {
+    int fd;
+};
+
+client_t *
+client_connect(const char *path)
+{
+    struct sockaddr_un addr;
+
+    if (path == NULL) {
+        path = PROTOCOL_DEFAULT_SOCKET;
+    }
+
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        return NULL;
+    }
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+
+    if (fd < 0) {
+        return NULL;
+    }
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, path);
+
+    if (connect(fd, (struct sockaddr *) &addr, sizeof(addr)) != 0) {
+        close(fd);
+        return NULL;
+    }
+
+    client_t *ret = malloc(sizeof(client_t));
+    assert(ret != NULL);
+    ret->fd = fd;
+    return ret;
+}
+
+void
+client_close(client_t *client)
+{
+    assert(client != NULL);
+    close(client->fd);
+    free(client);
+}
+
+int
+client_solve(client_t *client, int size, const int *clues, int *heights, int *flags)
+{
+    assert(client != NULL);
+    assert(clues != NULL);
+    assert(heights != NULL);
+    assert(size >= PROTOCOL_MIN_SIZE && size <= PROTOCOL_MAX_SIZE);
+    unsigned char body[PROTOCOL_MAX_BODY];
+    size_t length = PROTOCOL_HEADER + 4 * (size_t) size;
+
+    body[0] = PROTOCOL_VERSION;
+    body[1] = REQUEST_SOLVE;
+    body[2] = (unsigned char) size;
+    body[3] = 0;
+
+    for (int i = 0; i < 4 * size; i++) {
+        body[PROTOCOL_HEADER + i] = (unsigned char) clues[i];
+    }
+
+    if (frame_write(client->fd, body, length) != 0) {
+        return -1;
+    }
+
+    int n = frame_read(client->fd, body, sizeof(body));
+
+    if (n < PROTOCOL_HEADER || body[0] != PROTOCOL_VERSION) {
+        return -1;
+    }
+
+    int status = body[1];
+
+    if (flags != NULL) {
+        *flags = body[3];
+    }
+
+    if (status == RESPONSE_SOLVED) {
+        if (body[2] != size || n != PROTOCOL_HEADER + size * size) {
+            return -1;
+        }
+
+        for (int i = 0; i < size * size; i++) {
+            heights[i] = body[PROTOCOL_HEADER + i];
+        }
+    }
+
+    return status;
+}
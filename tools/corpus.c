@@ -0,0 +1,144 @@
+/* utf-8 */
+
+/**
+ * @file
+ * @brief Наборы головоломок для утилит.
+ * @details
+ *
+ * @date создан 19.10.2026
+ * @author Nick Egorrov
+ * @copyright http://www.apache.org/licenses/LICENSE-2.0
+ */
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "corpus.h"
+
+static const char *builtin[] = {
+    "4  2 2 1 3  2 2 3 1  1 2 2 3  3 2 1 3",
+    "4  0 0 1 2  0 2 0 0  0 3 0 0  0 1 0 0",
+    "5  5 0 3 1 0  0 1 0 0 5  3 0 0 0 0  0 2 0 0 0",
+    "5  0 4 0 0 0  0 0 5 1 0  0 3 5 0 3  0 3 0 4 0",
+    "5  0 5 0 0 0  0 0 2 0 0  0 4 0 0 3  0 0 0 3 0",
+    "6  0 0 0 2 2 0  0 0 0 6 3 0  0 4 0 0 0 0  4 4 0 3 0 0",
+    "6  3 2 2 3 2 1  1 2 3 3 2 2  5 1 2 2 4 3  3 2 1 2 2 4",
+    "7  0 2 3 0 2 0 0  5 0 4 5 0 4 0  0 4 2 0 0 0 6  5 2 2 2 2 4 1",
+    "7  7 0 0 0 2 2 3  0 0 3 0 0 0 0  3 0 3 0 0 5 0  0 0 0 0 5 0 4",
+    "7  3 3 2 1 2 2 3  4 3 2 4 1 4 2  2 4 1 4 5 3 2  3 1 4 2 5 2 3"
+};
+
+/**
+ * Разбирает строку набора.
+ *
+ * @return 1 если головоломка прочитана, 0 если строка пустая, -1 при ошибке.
+ */
+static int
+parse_line(const char *line, puzzle_t *puzzle)
+{
+    char *end;
+    long value = strtol(line, &end, 10);
+
+    if (end == line) {
+        while (*line == ' ' || *line == '\t' || *line == '\r' || *line == '\n') {
+            line++;
+        }
+
+        return *line == '\0' || *line == '#' ? 0 : -1;
+    }
+
+    if (value < PROTOCOL_MIN_SIZE || value > PROTOCOL_MAX_SIZE) {
+        return -1;
+    }
+
+    puzzle->size = (int) value;
+
+    for (int i = 0; i < 4 * puzzle->size; i++) {
+        line = end;
+        value = strtol(line, &end, 10);
+
+        if (end == line || value < 0 || value > puzzle->size) {
+            return -1;
+        }
+
+        puzzle->clues[i] = (int) value;
+    }
+
+    return 1;
+}
+
+static void
+corpus_add(corpus_t *corpus, int *capacity, const puzzle_t *puzzle)
+{
+    if (corpus->count == *capacity) {
+        *capacity = *capacity == 0 ? 16 : 2 * *capacity;
+        corpus->puzzles = realloc(corpus->puzzles, (size_t) *capacity * sizeof(puzzle_t));
+        assert(corpus->puzzles != NULL);
+    }
+
+    corpus->puzzles[corpus->count++] = *puzzle;
+}
+
+corpus_t *
+corpus_builtin(void)
+{
+    corpus_t *ret = calloc(1, sizeof(corpus_t));
+    int capacity = 0;
+    puzzle_t puzzle;
+    assert(ret != NULL);
+
+    for (size_t i = 0; i < sizeof(builtin) / sizeof(builtin[0]); i++) {
+        int parsed = parse_line(builtin[i], &puzzle);
+        assert(parsed == 1);
+        (void) parsed;
+        corpus_add(ret, &capacity, &puzzle);
+    }
+
+    return ret;
+}
+
+corpus_t *
+corpus_load(const char *path)
+{
+    FILE *io = fopen(path, "r");
+
+    if (io == NULL) {
+        perror(path);
+        return NULL;
+    }
+
+    corpus_t *ret = calloc(1, sizeof(corpus_t));
+    int capacity = 0;
+    int line_no = 0;
+    char line[4096];
+    puzzle_t puzzle;
+    assert(ret != NULL);
+
+    while (fgets(line, sizeof(line), io) != NULL) {
+        line_no++;
+        int parsed = parse_line(line, &puzzle);
+
+        if (parsed < 0) {
+            fprintf(stderr, "%s:%d: bad puzzle\n", path, line_no);
+            corpus_free(ret);
+            fclose(io);
+            return NULL;
+        }
+
+        if (parsed > 0) {
+            corpus_add(ret, &capacity, &puzzle);
+        }
+    }
+
+    fclose(io);
+    return ret;
+}
+
+void
+corpus_free(corpus_t *corpus)
+{
+    assert(corpus != NULL);
+    free(corpus->puzzles);
+    free(corpus);
+}
@@ -0,0 +1,45 @@
+/* utf-8 */
+
+/**
+ * @file
+ * @brief Наборы головоломок для утилит.
+ * @details Файл набора содержит по одной головоломке в строке: размер и следом 4 * размер
+ * подсказок в порядке city_load_clues(). Пустые строки и строки, начинающиеся с '#',
+ * пропускаются.
+ *
+ * @date создан 19.10.2026
+ * @author Nick Egorrov
+ * @copyright http://www.apache.org/licenses/LICENSE-2.0
+ */
+
+#ifndef _CORPUS_H
+#define _CORPUS_H
+
+#include "skyskrapers/protocol.h"
+
+typedef struct _puzzle {
+    int size;
+    int clues[4 * PROTOCOL_MAX_SIZE];
+} puzzle_t;
+
+typedef struct _corpus {
+    int count;
+    puzzle_t *puzzles;
+} corpus_t;
+
+/** Встроенный набор из головоломок тестов. */
+extern corpus_t *
+corpus_builtin(void);
+
+/**
+ * Загружает набор из файла.
+ *
+ * @return Набор или NULL, если файл не прочитан или содержит ошибки.
+ */
+extern corpus_t *
+corpus_load(const char *path);
+
+extern void
+corpus_free(corpus_t *corpus);
+
+#endif /* _CORPUS_H */
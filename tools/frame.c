@@ -0,0 +1,112 @@
+/* utf-8 */
+
+/**
+ * @file
+ * @brief Чтение и запись кадров протокола.
+ * @details
+ *
+ * @date создан 19.10.2026
+ * @author Nick Egorrov
+ * @copyright http://www.apache.org/licenses/LICENSE-2.0
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include "skyskrapers/protocol.h"
+#include "frame.h"
+
+/** @return Количество прочитанных байт, меньше @p length только при закрытии соединения. */
+static ssize_t
+read_full(int fd, unsigned char *buf, size_t length)
+{
+    size_t done = 0;
+
+    while (done < length) {
+        ssize_t n = read(fd, buf + done, length - done);
+
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+
+        if (n < 0) {
+            return -1;
+        }
+
+        if (n == 0) {
+            break;
+        }
+
+        done += (size_t) n;
+    }
+
+    return (ssize_t) done;
+}
+
+static int
+write_full(int fd, const unsigned char *buf, size_t length)
+{
+    size_t done = 0;
+
+    while (done < length) {
+        ssize_t n = write(fd, buf + done, length - done);
+
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+
+        if (n <= 0) {
+            return -1;
+        }
+
+        done += (size_t) n;
+    }
+
+    return 0;
+}
+
+int
+frame_read(int fd, unsigned char *body, size_t capacity)
+{
+    unsigned char prefix[4];
+    ssize_t n = read_full(fd, prefix, sizeof(prefix));
+
+    if (n == 0) {
+        return 0;
+    }
+
+    if (n != sizeof(prefix)) {
+        return -1;
+    }
+
+    size_t length = (size_t) prefix[0] | (size_t) prefix[1] << 8
+                    | (size_t) prefix[2] << 16 | (size_t) prefix[3] << 24;
+
+    if (length == 0 || length > capacity) {
+        return -1;
+    }
+
+    if (read_full(fd, body, length) != (ssize_t) length) {
+        return -1;
+    }
+
+    return (int) length;
+}
+
+int
+frame_write(int fd, const unsigned char *body, size_t length)
+{
+    /* Кадр отправляется одним вызовом, чтобы получатель не просыпался дважды. */
+    unsigned char frame[4 + PROTOCOL_MAX_BODY];
+
+    if (length > PROTOCOL_MAX_BODY) {
+        return -1;
+    }
+
+    frame[0] = (unsigned char) length;
+    frame[1] = (unsigned char) (length >> 8);
+    frame[2] = (unsigned char) (length >> 16);
+    frame[3] = (unsigned char) (length >> 24);
+    memcpy(frame + 4, body, length);
+    return write_full(fd, frame, 4 + length);
+}
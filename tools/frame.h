@@ -0,0 +1,38 @@
+/* utf-8 */
+
+/**
+ * @file
+ * @brief Чтение и запись кадров протокола.
+ * @details Функции повторяют системные вызовы при прерывании сигналом и частичной передаче.
+ *
+ * @date создан 19.10.2026
+ * @author Nick Egorrov
+ * @copyright http://www.apache.org/licenses/LICENSE-2.0
+ */
+
+#ifndef _FRAME_H
+#define _FRAME_H
+
+#include <stddef.h>
+
+/**
+ * Читает кадр.
+ *
+ * @param fd Сокет.
+ * @param [out] body Буфер для тела кадра.
+ * @param capacity Размер буфера.
+ * @return Длина тела, 0 если соединение закрыто до начала кадра, -1 при ошибке или если тело
+ * не помещается в буфер.
+ */
+extern int
+frame_read(int fd, unsigned char *body, size_t capacity);
+
+/**
+ * Записывает кадр.
+ *
+ * @return 0 или -1 при ошибке.
+ */
+extern int
+frame_write(int fd, const unsigned char *body, size_t length);
+
+#endif /* _FRAME_H */
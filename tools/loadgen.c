@@ -0,0 +1,251 @@
+/* utf-8 */
+
+/**
+ * @file
+ * @brief Генератор нагрузки для сервера решений.
+ * @details Каждое соединение обслуживается отдельным потоком, который последовательно
+ * отправляет запросы и замеряет время ответа. В конце печатается пропускная способность и
+ * распределение задержек.
+ *
+ * @verbatim
+   skyskrapers-loadgen [-s socket] [-c connections] [-n requests] [-f corpus] [-r]
+
+   -c  количество одновременных соединений
+   -n  количество запросов на соединение
+   -f  файл набора головоломок, по умолчанию встроенный набор
+   -r  случайно поворачивать и отражать головоломки
+   @endverbatim
+ *
+ * @date создан 19.10.2026
+ * @author Nick Egorrov
+ * @copyright http://www.apache.org/licenses/LICENSE-2.0
+ */
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "skyskrapers/protocol.h"
+#include "skyskrapers/client.h"
+#include "corpus.h"
+
+typedef struct _job {
+    const char *path;
+    const corpus_t *corpus;
+    int requests;
+    bool randomize;
+    unsigned int seed;
+    /** Задержки запросов в наносекундах. */
+    double *latency;
+    int done;
+    int solved;
+    int cached;
+    int timeouts;
+    int failed;
+} job_t;
+
+static double
+now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec * 1e9 + (double) ts.tv_nsec;
+}
+
+/** Поворачивает головоломку @p t & 3 раз и отражает, если установлен бит 2. */
+static void
+transform(int size, const int *src, int *dst, int t)
+{
+    int len = 4 * size;
+
+    for (int j = 0; j < len; j++) {
+        int i = j - (t & 3) * size;
+
+        if ((t & 4) != 0) {
+            i = size - 1 - i;
+        }
+
+        i %= len;
+        dst[j] = src[i < 0 ? i + len : i];
+    }
+}
+
+static void *
+run(void *arg)
+{
+    job_t *job = arg;
+    client_t *client = client_connect(job->path);
+    int clues[4 * PROTOCOL_MAX_SIZE];
+    int heights[PROTOCOL_MAX_SIZE * PROTOCOL_MAX_SIZE];
+
+    if (client == NULL) {
+        job->failed = job->requests;
+        return NULL;
+    }
+
+    for (int i = 0; i < job->requests; i++) {
+        const puzzle_t *p = &job->corpus->puzzles[rand_r(&job->seed) % job->corpus->count];
+        int t = job->randomize ? rand_r(&job->seed) & 7 : 0;
+        int flags = 0;
+        transform(p->size, p->clues, clues, t);
+
+        double start = now_ns();
+        int status = client_solve(client, p->size, clues, heights, &flags);
+        job->latency[job->done++] = now_ns() - start;
+
+        if (status < 0) {
+            job->failed += job->requests - i;
+            break;
+        }
+
+        if (status == RESPONSE_SOLVED) {
+            job->solved++;
+        } else if (status == RESPONSE_TIMEOUT) {
+            job->timeouts++;
+        }
+
+        if ((flags & RESPONSE_FLAG_CACHED) != 0) {
+            job->cached++;
+        }
+    }
+
+    client_close(client);
+    return NULL;
+}
+
+static int
+compare(const void *a, const void *b)
+{
+    double x = *(const double *) a;
+    double y = *(const double *) b;
+    return x < y ? -1 : x > y;
+}
+
+static double
+percentile(const double *sorted, int count, double p)
+{
+    int i = (int) (p * (count - 1) + 0.5);
+    return sorted[i];
+}
+
+static void
+usage(const char *name)
+{
+    fprintf(stderr, "Usage: %s [-s socket] [-c connections] [-n requests] [-f corpus] [-r]\n",
+            name);
+}
+
+int
+main(int argc, char **argv)
+{
+    const char *path = PROTOCOL_DEFAULT_SOCKET;
+    const char *corpus_path = NULL;
+    int connections = 4;
+    int requests = 10000;
+    bool randomize = false;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "s:c:n:f:rh")) != -1) {
+        switch (opt) {
+        case 's':
+            path = optarg;
+            break;
+
+        case 'c':
+            connections = atoi(optarg);
+            break;
+
+        case 'n':
+            requests = atoi(optarg);
+            break;
+
+        case 'f':
+            corpus_path = optarg;
+            break;
+
+        case 'r':
+            randomize = true;
+            break;
+
+        default:
+            usage(argv[0]);
+            return opt == 'h' ? 0 : 1;
+        }
+    }
+
+    if (connections < 1 || requests < 1) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    corpus_t *corpus = corpus_path ? corpus_load(corpus_path) : corpus_builtin();
+
+    if (corpus == NULL || corpus->count == 0) {
+        return 1;
+    }
+
+    job_t *jobs = calloc((size_t) connections, sizeof(job_t));
+    pthread_t *threads = malloc((size_t) connections * sizeof(pthread_t));
+
+    for (int i = 0; i < connections; i++) {
+        jobs[i].path = path;
+        jobs[i].corpus = corpus;
+        jobs[i].requests = requests;
+        jobs[i].randomize = randomize;
+        jobs[i].seed = (unsigned int) i * 7919u + 1u;
+        jobs[i].latency = malloc((size_t) requests * sizeof(double));
+    }
+
+    double start = now_ns();
+
+    for (int i = 0; i < connections; i++) {
+        pthread_create(&threads[i], NULL, run, &jobs[i]);
+    }
+
+    for (int i = 0; i < connections; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    double elapsed = now_ns() - start;
+    int total = 0, solved = 0, cached = 0, timeouts = 0, failed = 0;
+    double *all = malloc((size_t) connections * (size_t) requests * sizeof(double));
+    double sum = 0;
+
+    for (int i = 0; i < connections; i++) {
+        memcpy(&all[total], jobs[i].latency, (size_t) jobs[i].done * sizeof(double));
+        total += jobs[i].done;
+        solved += jobs[i].solved;
+        cached += jobs[i].cached;
+        timeouts += jobs[i].timeouts;
+        failed += jobs[i].failed;
+        free(jobs[i].latency);
+    }
+
+    printf("requests   %d (solved %d, from cache %d, timeouts %d, failed %d)\n", total, solved,
+           cached, timeouts, failed);
+
+    if (total > 0) {
+        for (int i = 0; i < total; i++) {
+            sum += all[i];
+        }
+
+        qsort(all, (size_t) total, sizeof(double), compare);
+        printf("throughput %.0f req/s\n", total / (elapsed / 1e9));
+        printf("latency us mean %.1f  p50 %.1f  p90 %.1f  p99 %.1f  max %.1f\n",
+               sum / total / 1e3,
+               percentile(all, total, 0.50) / 1e3,
+               percentile(all, total, 0.90) / 1e3,
+               percentile(all, total, 0.99) / 1e3,
+               all[total - 1] / 1e3);
+    }
+
+    free(all);
+    free(threads);
+    free(jobs);
+    corpus_free(corpus);
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,160 @@
+/* utf-8 */
+
+/**
+ * @file
+ * @brief Аппаратные счётчики процессора для утилит.
+ * @details
+ *
+ * @date создан 19.10.2026
+ * @author Nick Egorrov
+ * @copyright http://www.apache.org/licenses/LICENSE-2.0
+ */
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "perf.h"
+
+const char *const perf_names[PERF_COUNTERS] = {
+    "cycles", "instr", "L1d miss", "LLC miss", "br miss"
+};
+
+#ifdef __linux__
+
+#define CACHE_READ_MISS(cache) ((cache) | (PERF_COUNT_HW_CACHE_OP_READ << 8) \
+                                | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16))
+
+static const struct _event {
+    unsigned int type;
+    unsigned long long config;
+} events[PERF_COUNTERS] = {
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {PERF_TYPE_HW_CACHE, CACHE_READ_MISS(PERF_COUNT_HW_CACHE_L1D)},
+    {PERF_TYPE_HW_CACHE, CACHE_READ_MISS(PERF_COUNT_HW_CACHE_LL)},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES}
+};
+
+int
+perf_open(perf_t *perf)
+{
+    int count = 0;
+
+    for (int i = 0; i < PERF_COUNTERS; i++) {
+        struct perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = events[i].type;
+        attr.config = events[i].config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        perf->fd[i] = (int) syscall(SYS_perf_event_open, &attr, 0, -1, -1, PERF_FLAG_FD_CLOEXEC);
+
+        if (perf->fd[i] >= 0) {
+            count++;
+        }
+    }
+
+    return count;
+}
+
+/** Читает значение, время включения и время работы счётчика. */
+static bool
+perf_read(int fd, unsigned long long data[3])
+{
+    size_t size = 3 * sizeof(unsigned long long);
+    return fd >= 0 && read(fd, data, size) == (ssize_t) size;
+}
+
+void
+perf_start(perf_t *perf)
+{
+    /* PERF_EVENT_IOC_RESET обнуляет только значение, а времена копятся с открытия счётчика,
+     * поэтому для каждого замера берутся приращения всех трёх показаний. */
+    for (int i = 0; i < PERF_COUNTERS; i++) {
+        if (!perf_read(perf->fd[i], perf->start[i])) {
+            continue;
+        }
+
+        ioctl(perf->fd[i], PERF_EVENT_IOC_ENABLE, 0);
+    }
+}
+
+void
+perf_stop(perf_t *perf, long long values[PERF_COUNTERS])
+{
+    for (int i = 0; i < PERF_COUNTERS; i++) {
+        if (perf->fd[i] >= 0) {
+            ioctl(perf->fd[i], PERF_EVENT_IOC_DISABLE, 0);
+        }
+    }
+
+    for (int i = 0; i < PERF_COUNTERS; i++) {
+        unsigned long long data[3];
+        values[i] = -1;
+
+        if (!perf_read(perf->fd[i], data)) {
+            continue;
+        }
+
+        unsigned long long value = data[0] - perf->start[i][0];
+        unsigned long long enabled = data[1] - perf->start[i][1];
+        unsigned long long running = data[2] - perf->start[i][2];
+
+        if (running == 0) {
+            continue;
+        }
+
+        /* Счётчиков больше, чем регистров процессора: значение досчитывается по времени. */
+        values[i] = (long long) ((double) value * (double) enabled / (double) running);
+    }
+}
+
+#else
+
+int
+perf_open(perf_t *perf)
+{
+    for (int i = 0; i < PERF_COUNTERS; i++) {
+        perf->fd[i] = -1;
+    }
+
+    return 0;
+}
+
+void
+perf_start(perf_t *perf)
+{
+    (void) perf;
+}
+
+void
+perf_stop(perf_t *perf, long long values[PERF_COUNTERS])
+{
+    (void) perf;
+
+    for (int i = 0; i < PERF_COUNTERS; i++) {
+        values[i] = -1;
+    }
+}
+
+#endif
+
+void
+perf_close(perf_t *perf)
+{
+    for (int i = 0; i < PERF_COUNTERS; i++) {
+        if (perf->fd[i] >= 0) {
+            close(perf->fd[i]);
+            perf->fd[i] = -1;
+        }
+    }
+}
@@ -0,0 +1,64 @@
+/* utf-8 */
+
+/**
+ * @file
+ * @brief Аппаратные счётчики процессора для утилит.
+ * @details Счётчики открываются через perf_event_open(2) для текущего потока, только
+ * пользовательский режим. Каждый счётчик открывается отдельно, поэтому недоступные
+ * процессору или запрещённые настройкой perf_event_paranoid счётчики просто пропускаются.
+ * Вне Linux счётчиков нет.
+ *
+ * @date создан 19.10.2026
+ * @author Nick Egorrov
+ * @copyright http://www.apache.org/licenses/LICENSE-2.0
+ */
+
+#ifndef _PERF_H
+#define _PERF_H
+
+enum _perf_counters {
+    PERF_CYCLES,
+    PERF_INSTRUCTIONS,
+    PERF_L1D_MISSES,
+    PERF_LLC_MISSES,
+    PERF_BRANCH_MISSES,
+    PERF_COUNTERS
+};
+
+typedef struct _perf {
+    /** Дескрипторы счётчиков, -1 для недоступного счётчика. */
+    int fd[PERF_COUNTERS];
+    /** Значение, время включения и время работы счётчиков при perf_start(). */
+    unsigned long long start[PERF_COUNTERS][3];
+} perf_t;
+
+/** Короткие имена счётчиков для заголовков таблиц. */
+extern const char *const perf_names[PERF_COUNTERS];
+
+/**
+ * Открывает счётчики.
+ *
+ * @return Количество доступных счётчиков, 0 если счётчиков нет.
+ */
+extern int
+perf_open(perf_t *perf);
+
+extern void
+perf_close(perf_t *perf);
+
+/**
+ * Запоминает показания и запускает доступные счётчики.
+ */
+extern void
+perf_start(perf_t *perf);
+
+/**
+ * Останавливает счётчики и читает их.
+ *
+ * @param [out] values Приращения счётчиков с perf_start() с поправкой на разделение времени
+ * между счётчиками, -1 для недоступного или не работавшего счётчика.
+ */
+extern void
+perf_stop(perf_t *perf, long long values[PERF_COUNTERS]);
+
+#endif /* _PERF_H */
@@ -0,0 +1,416 @@
+/* utf-8 */
+
+/**
+ * @file
+ * @brief Решение набора головоломок в нескольких процессах.
+ * @details Родительский процесс создаёт общую для всех процессов область памяти (mmap) с
+ * очередью, результатами и счётчиками и запускает рабочие процессы. Рабочий процесс забирает
+ * из очереди диапазон индексов атомарным сложением, решает головоломки и пишет высоты прямо в
+ * общую область. Текущий диапазон каждого процесса тоже лежит в общей области, поэтому упавший
+ * процесс перезапускается и продолжает свой диапазон. Головоломка, на которой процесс упал
+ * MAX_ATTEMPTS раз, отмечается как ошибочная. В конце печатается пропускная способность.
+ *
+ * @verbatim
+   skyskrapers-shard [-w workers] [-b batch] [-f corpus] [-n repeat] [-T timeout] [-o output]
+
+   -w  количество рабочих процессов, по умолчанию количество процессоров
+   -b  количество головоломок, которое процесс забирает из очереди за раз
+   -f  файл набора головоломок, по умолчанию встроенный набор
+   -n  сколько раз повторить набор
+   -T  срок решения одной головоломки в миллисекундах, 0 - без срока
+   -o  файл решений, по строке на головоломку: размер и высоты построчно или "-"
+   -x  упасть на головоломке с этим индексом при первой попытке, для проверки перезапуска
+   @endverbatim
+ *
+ * @date создан 19.10.2026
+ * @author Nick Egorrov
+ * @copyright http://www.apache.org/licenses/LICENSE-2.0
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "skyskrapers/skyskrapers.h"
+#include "skyskrapers/city.h"
+#include "skyskrapers/tower.h"
+#include "corpus.h"
+
+#define MAX_WORKERS 256
+/** Сколько раз головоломка может уронить процесс, прежде чем она будет пропущена. */
+#define MAX_ATTEMPTS 2
+/** Наибольшее общее количество перезапусков, после него процессы больше не запускаются. */
+#define MAX_RESTARTS 1000
+
+#define FETCH_ADD(ptr, value) __atomic_fetch_add(ptr, value, __ATOMIC_RELAXED)
+#define LOAD(ptr) __atomic_load_n(ptr, __ATOMIC_ACQUIRE)
+#define STORE(ptr, value) __atomic_store_n(ptr, value, __ATOMIC_RELEASE)
+
+enum _status {
+    STATUS_PENDING,
+    STATUS_SOLVED,
+    STATUS_UNSOLVABLE,
+    STATUS_TIMEOUT,
+    /** Головоломка роняет рабочий процесс. */
+    STATUS_FAILED
+};
+
+/** Диапазон головоломок рабочего процесса, start продвигается после каждой головоломки. */
+typedef struct _claim {
+    long start;
+    long end;
+} claim_t;
+
+/** Начало общей области, за ним идут массивы status, attempts и heights. */
+typedef struct _shared {
+    /** Следующая головоломка, которую никто не забрал. */
+    long next;
+    unsigned long counts[STATUS_FAILED + 1];
+    claim_t claims[MAX_WORKERS];
+} shared_t;
+
+typedef struct _runner {
+    const corpus_t *corpus;
+    /** Количество головоломок с учётом повторов. */
+    long count;
+    long batch;
+    long timeout;
+    long crash_at;
+    shared_t *shared;
+    size_t shared_size;
+    unsigned char *status;
+    unsigned char *attempts;
+    /** Высоты всех головоломок подряд. */
+    unsigned char *heights;
+    /** Смещение высот головоломки в runner_t::heights. */
+    size_t *offsets;
+} runner_t;
+
+static double
+now_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec + (double) ts.tv_nsec / 1e9;
+}
+
+static const puzzle_t *
+runner_puzzle(const runner_t *runner, long index)
+{
+    return &runner->corpus->puzzles[index % runner->corpus->count];
+}
+
+static bool
+runner_map(runner_t *runner)
+{
+    long count = runner->count;
+    runner->offsets = malloc((size_t) count * sizeof(size_t));
+
+    if (runner->offsets == NULL) {
+        return false;
+    }
+
+    size_t cells = 0;
+
+    for (long i = 0; i < count; i++) {
+        int size = runner_puzzle(runner, i)->size;
+        runner->offsets[i] = cells;
+        cells += (size_t) (size * size);
+    }
+
+    runner->shared_size = sizeof(shared_t) + 2 * (size_t) count + cells;
+    void *mem = mmap(NULL, runner->shared_size, PROT_READ | PROT_WRITE,
+                     MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+
+    if (mem == MAP_FAILED) {
+        perror("mmap");
+        return false;
+    }
+
+    /* Анонимное отображение уже заполнено нулями: очередь пуста, все головоломки
+     * STATUS_PENDING. */
+    runner->shared = mem;
+    runner->status = (unsigned char *) mem + sizeof(shared_t);
+    runner->attempts = runner->status + count;
+    runner->heights = runner->attempts + count;
+    return true;
+}
+
+static void
+solve_one(runner_t *runner, long index)
+{
+    const puzzle_t *puzzle = runner_puzzle(runner, index);
+    unsigned char attempt = ++runner->attempts[index];
+
+    if (attempt > MAX_ATTEMPTS) {
+        runner->status[index] = STATUS_FAILED;
+        FETCH_ADD(&runner->shared->counts[STATUS_FAILED], 1ul);
+        return;
+    }
+
+    if (index == runner->crash_at && attempt == 1) {
+        abort();
+    }
+
+    city_t *city = city_new(puzzle->size);
+    city_set_log(city, NULL);
+    int status = STATUS_UNSOLVABLE;
+
+    if (city_load_clues(city, puzzle->clues)) {
+        solve_options_t options;
+        solve_options_init(&options);
+
+        if (runner->timeout > 0) {
+            solve_options_set_timeout(&options, runner->timeout);
+        }
+
+        solve_status_t result = city_solve_with(city, &options);
+        status = result == SOLVE_SOLVED ? STATUS_SOLVED
+                 : result == SOLVE_TIMEOUT ? STATUS_TIMEOUT : STATUS_UNSOLVABLE;
+    }
+
+    if (status == STATUS_SOLVED) {
+        unsigned char *out = runner->heights + runner->offsets[index];
+
+        for (int i = 0; i < puzzle->size * puzzle->size; i++) {
+            out[i] = (unsigned char) tower_get_height(&city->towers[i]);
+        }
+    }
+
+    city_free(city);
+    STORE(&runner->status[index], (unsigned char) status);
+    FETCH_ADD(&runner->shared->counts[status], 1ul);
+}
+
+/** Рабочий процесс: сначала доделывает свой диапазон, затем забирает новые из очереди. */
+static void
+worker(runner_t *runner, int id)
+{
+    claim_t *claim = &runner->shared->claims[id];
+
+    for (;;) {
+        long start = LOAD(&claim->start);
+
+        if (start >= LOAD(&claim->end)) {
+            start = FETCH_ADD(&runner->shared->next, runner->batch);
+
+            if (start >= runner->count) {
+                break;
+            }
+
+            STORE(&claim->start, start);
+            STORE(&claim->end, start + runner->batch < runner->count
+                  ? start + runner->batch : runner->count);
+        }
+
+        if (LOAD(&runner->status[start]) == STATUS_PENDING) {
+            solve_one(runner, start);
+        }
+
+        STORE(&claim->start, start + 1);
+    }
+}
+
+static pid_t
+spawn(runner_t *runner, int id)
+{
+    pid_t pid = fork();
+
+    if (pid == 0) {
+        worker(runner, id);
+        _exit(0);
+    }
+
+    if (pid < 0) {
+        perror("fork");
+    }
+
+    return pid;
+}
+
+static void
+write_output(const runner_t *runner, FILE *out)
+{
+    for (long i = 0; i < runner->count; i++) {
+        int size = runner_puzzle(runner, i)->size;
+        fprintf(out, "%d ", size);
+
+        if (runner->status[i] != STATUS_SOLVED) {
+            fprintf(out, " -\n");
+            continue;
+        }
+
+        const unsigned char *heights = runner->heights + runner->offsets[i];
+
+        for (int j = 0; j < size * size; j++) {
+            fprintf(out, "%s%d", j % size == 0 ? "  " : " ", heights[j]);
+        }
+
+        fprintf(out, "\n");
+    }
+}
+
+static void
+usage(const char *name)
+{
+    fprintf(stderr, "Usage: %s [-w workers] [-b batch] [-f corpus] [-n repeat] [-T timeout] "
+            "[-o output] [-x index]\n", name);
+}
+
+int
+main(int argc, char **argv)
+{
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    int workers = cpus > 0 ? (int) cpus : 1;
+    long repeat = 1;
+    const char *corpus_path = NULL;
+    const char *output = NULL;
+    runner_t runner;
+    memset(&runner, 0, sizeof(runner));
+    runner.batch = 16;
+    runner.crash_at = -1;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "w:b:f:n:T:o:x:h")) != -1) {
+        switch (opt) {
+        case 'w':
+            workers = atoi(optarg);
+            break;
+
+        case 'b':
+            runner.batch = atol(optarg);
+            break;
+
+        case 'f':
+            corpus_path = optarg;
+            break;
+
+        case 'n':
+            repeat = atol(optarg);
+            break;
+
+        case 'T':
+            runner.timeout = atol(optarg);
+            break;
+
+        case 'o':
+            output = optarg;
+            break;
+
+        case 'x':
+            runner.crash_at = atol(optarg);
+            break;
+
+        default:
+            usage(argv[0]);
+            return opt == 'h' ? 0 : 1;
+        }
+    }
+
+    if (workers < 1 || workers > MAX_WORKERS || runner.batch < 1 || repeat < 1
+            || runner.timeout < 0) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    corpus_t *corpus = corpus_path ? corpus_load(corpus_path) : corpus_builtin();
+
+    if (corpus == NULL || corpus->count == 0) {
+        fprintf(stderr, "Empty corpus\n");
+        return 1;
+    }
+
+    runner.corpus = corpus;
+    runner.count = corpus->count * repeat;
+
+    if (!runner_map(&runner)) {
+        return 1;
+    }
+
+    /* Таблицы подсказок строятся один раз до fork() и достаются процессам готовыми. */
+    city_prepare_tables(PROTOCOL_MAX_SIZE);
+    pid_t pids[MAX_WORKERS];
+    int running = 0;
+    int restarts = 0;
+    double start = now_s();
+
+    for (int i = 0; i < workers; i++) {
+        pids[i] = spawn(&runner, i);
+        running += pids[i] > 0;
+    }
+
+    while (running > 0) {
+        int wstatus;
+        pid_t pid = wait(&wstatus);
+
+        if (pid < 0) {
+            break;
+        }
+
+        int id = 0;
+
+        while (id < workers && pids[id] != pid) {
+            id++;
+        }
+
+        running--;
+
+        if (id == workers || (WIFEXITED(wstatus) && WEXITSTATUS(wstatus) == 0)) {
+            continue;
+        }
+
+        fprintf(stderr, "Worker %d (pid %d) %s %d, restarting\n", id, (int) pid,
+                WIFSIGNALED(wstatus) ? "killed by signal" : "exited with",
+                WIFSIGNALED(wstatus) ? WTERMSIG(wstatus) : WEXITSTATUS(wstatus));
+
+        if (restarts < MAX_RESTARTS) {
+            restarts++;
+            pids[id] = spawn(&runner, id);
+            running += pids[id] > 0;
+        }
+    }
+
+    /* Головоломки, которые остались незаконченными (например, процесс упал между взятием
+     * диапазона из очереди и его записью), решаются здесь же. */
+    long recovered = 0;
+    runner.crash_at = -1;
+
+    for (long i = 0; i < runner.count; i++) {
+        if (runner.status[i] == STATUS_PENDING) {
+            solve_one(&runner, i);
+            recovered++;
+        }
+    }
+
+    double elapsed = now_s() - start;
+    const unsigned long *counts = runner.shared->counts;
+    printf("puzzles %ld, workers %d, time %.3f s, %.1f puzzles/s\n", runner.count, workers,
+           elapsed, elapsed > 0 ? (double) runner.count / elapsed : 0.0);
+    printf("solved %lu, unsolvable %lu, timeout %lu, failed %lu, restarts %d, recovered %ld\n",
+           counts[STATUS_SOLVED], counts[STATUS_UNSOLVABLE], counts[STATUS_TIMEOUT],
+           counts[STATUS_FAILED], restarts, recovered);
+
+    int code = 0;
+
+    if (output != NULL) {
+        FILE *out = fopen(output, "w");
+
+        if (out == NULL) {
+            perror(output);
+            code = 1;
+        } else {
+            write_output(&runner, out);
+            code = fclose(out) == 0 ? 0 : 1;
+        }
+    }
+
+    munmap(runner.shared, runner.shared_size);
+    free(runner.offsets);
+    corpus_free(corpus);
+    return code;
+}
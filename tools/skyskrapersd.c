@@ -0,0 +1,455 @@
+/* utf-8 */
+
+/**
+ * @file
+ * @brief Сервер решений.
+ * @details Сервер слушает локальный сокет и решает головоломки по протоколу protocol.h.
+ * Потоки-обработчики запускаются один раз при старте и берут соединения из общей очереди,
+ * соединение обслуживается одним потоком до закрытия. Кэш решений общий для всех потоков.
+ *
+ * @verbatim
+   skyskrapersd [-s socket] [-t threads] [-c capacity] [-T timeout]
+
+   -T  срок решения одной головоломки в миллисекундах, 0 - без срока
+   @endverbatim
+ *
+ * @date создан 19.10.2026
+ * @author Nick Egorrov
+ * @copyright http://www.apache.org/licenses/LICENSE-2.0
+ */
+
+#include <assert.h>
+#include <errno.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "skyskrapers/skyskrapers.h"
+#include "skyskrapers/city.h"
+#include "skyskrapers/tower.h"
+#include "skyskrapers/cache.h"
+#include "skyskrapers/protocol.h"
+#include "frame.h"
+
+typedef struct _worker_stats {
+    unsigned long long requests;
+    unsigned long long solved;
+    unsigned long long cached;
+    unsigned long long rejected;
+    unsigned long long timeouts;
+} worker_stats_t;
+
+typedef struct _server {
+    int listen_fd;
+    int threads;
+    /** Срок решения в миллисекундах. */
+    long timeout;
+    pthread_t *workers;
+    worker_stats_t *stats;
+
+    /* Очередь принятых соединений, кольцевой буфер. */
+    pthread_mutex_t lock;
+    pthread_cond_t ready;
+    int *queue;
+    int queue_capacity;
+    int queue_head;
+    int queue_count;
+    /** Соединение, которое обслуживает поток, или -1. */
+    int *active;
+    bool stop;
+
+    pthread_mutex_t cache_lock;
+    cache_t *cache;
+} server_t;
+
+typedef struct _worker_arg {
+    server_t *server;
+    int id;
+} worker_arg_t;
+
+static volatile sig_atomic_t interrupted = 0;
+
+static void
+on_signal(int sig)
+{
+    (void) sig;
+    interrupted = 1;
+}
+
+/*+************************************
+ *  Обработка запросов
+ **************************************/
+
+static size_t
+respond(unsigned char *body, int status, int size, int flags)
+{
+    body[0] = PROTOCOL_VERSION;
+    body[1] = (unsigned char) status;
+    body[2] = (unsigned char) size;
+    body[3] = (unsigned char) flags;
+    return PROTOCOL_HEADER;
+}
+
+/**
+ * Обрабатывает запрос и записывает ответ на его место.
+ *
+ * @return Длина ответа.
+ */
+static size_t
+handle(server_t *server, worker_stats_t *stats, unsigned char *body, int length)
+{
+    int clues[4 * PROTOCOL_MAX_SIZE];
+    int heights[PROTOCOL_MAX_SIZE * PROTOCOL_MAX_SIZE];
+
+    if (length < PROTOCOL_HEADER || body[0] != PROTOCOL_VERSION || body[1] != REQUEST_SOLVE) {
+        stats->rejected++;
+        return respond(body, RESPONSE_BAD_REQUEST, 0, 0);
+    }
+
+    int size = body[2];
+
+    if (size < PROTOCOL_MIN_SIZE || size > PROTOCOL_MAX_SIZE
+            || length != PROTOCOL_HEADER + 4 * size) {
+        stats->rejected++;
+        return respond(body, RESPONSE_BAD_REQUEST, 0, 0);
+    }
+
+    for (int i = 0; i < 4 * size; i++) {
+        clues[i] = body[PROTOCOL_HEADER + i];
+
+        if (clues[i] > size) {
+            stats->rejected++;
+            return respond(body, RESPONSE_BAD_REQUEST, size, 0);
+        }
+    }
+
+    pthread_mutex_lock(&server->cache_lock);
+    bool found = cache_find(server->cache, size, clues, heights);
+    pthread_mutex_unlock(&server->cache_lock);
+
+    if (found) {
+        stats->cached++;
+    } else {
+        city_t *city = city_new(size);
+        city_set_log(city, NULL);
+        solve_options_t options;
+        solve_options_init(&options);
+
+        if (server->timeout > 0) {
+            solve_options_set_timeout(&options, server->timeout);
+        }
+
+        solve_status_t status = SOLVE_UNSOLVABLE;
+
+        if (city_load_clues(city, clues)) {
+            status = city_solve_with(city, &options);
+        }
+
+        if (status != SOLVE_SOLVED) {
+            city_free(city);
+
+            if (status == SOLVE_TIMEOUT) {
+                stats->timeouts++;
+                return respond(body, RESPONSE_TIMEOUT, size, 0);
+            }
+
+            return respond(body, RESPONSE_UNSOLVED, size, 0);
+        }
+
+        for (int y = 0; y < size; y++) {
+            for (int x = 0; x < size; x++) {
+                heights[x + y * size] = tower_get_height(city_get_tower(city, TOP, x, y));
+            }
+        }
+
+        city_free(city);
+        pthread_mutex_lock(&server->cache_lock);
+        cache_put(server->cache, size, clues, heights);
+        pthread_mutex_unlock(&server->cache_lock);
+    }
+
+    stats->solved++;
+    size_t ret = respond(body, RESPONSE_SOLVED, size, found ? RESPONSE_FLAG_CACHED : 0);
+
+    for (int i = 0; i < size * size; i++) {
+        body[ret++] = (unsigned char) heights[i];
+    }
+
+    return ret;
+}
+
+static void
+serve(server_t *server, worker_stats_t *stats, int fd)
+{
+    unsigned char body[PROTOCOL_MAX_BODY];
+    int length;
+
+    while ((length = frame_read(fd, body, sizeof(body))) > 0) {
+        stats->requests++;
+        size_t answer = handle(server, stats, body, length);
+
+        if (frame_write(fd, body, answer) != 0) {
+            break;
+        }
+    }
+}
+
+static void *
+worker(void *arg)
+{
+    server_t *server = ((worker_arg_t *) arg)->server;
+    int id = ((worker_arg_t *) arg)->id;
+
+    for (;;) {
+        pthread_mutex_lock(&server->lock);
+
+        while (server->queue_count == 0 && !server->stop) {
+            pthread_cond_wait(&server->ready, &server->lock);
+        }
+
+        if (server->stop) {
+            pthread_mutex_unlock(&server->lock);
+            break;
+        }
+
+        int fd = server->queue[server->queue_head];
+        server->queue_head = (server->queue_head + 1) % server->queue_capacity;
+        server->queue_count--;
+        server->active[id] = fd;
+        pthread_mutex_unlock(&server->lock);
+
+        serve(server, &server->stats[id], fd);
+
+        pthread_mutex_lock(&server->lock);
+        server->active[id] = -1;
+        pthread_mutex_unlock(&server->lock);
+        close(fd);
+    }
+
+    return NULL;
+}
+
+/*+************************************
+ *  Сервер
+ **************************************/
+
+static void
+enqueue(server_t *server, int fd)
+{
+    pthread_mutex_lock(&server->lock);
+
+    if (server->queue_count == server->queue_capacity) {
+        int capacity = 2 * server->queue_capacity;
+        int *queue = malloc((size_t) capacity * sizeof(int));
+        assert(queue != NULL);
+
+        for (int i = 0; i < server->queue_count; i++) {
+            queue[i] = server->queue[(server->queue_head + i) % server->queue_capacity];
+        }
+
+        free(server->queue);
+        server->queue = queue;
+        server->queue_capacity = capacity;
+        server->queue_head = 0;
+    }
+
+    int tail = (server->queue_head + server->queue_count) % server->queue_capacity;
+    server->queue[tail] = fd;
+    server->queue_count++;
+    pthread_cond_signal(&server->ready);
+    pthread_mutex_unlock(&server->lock);
+}
+
+static int
+listen_on(const char *path)
+{
+    struct sockaddr_un addr;
+
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        fprintf(stderr, "Socket path is too long: %s\n", path);
+        return -1;
+    }
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+
+    if (fd < 0) {
+        perror("socket");
+        return -1;
+    }
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, path);
+    unlink(path);
+
+    if (bind(fd, (struct sockaddr *) &addr, sizeof(addr)) != 0 || listen(fd, SOMAXCONN) != 0) {
+        perror(path);
+        close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+
+static void
+usage(const char *name)
+{
+    fprintf(stderr, "Usage: %s [-s socket] [-t threads] [-c capacity] [-T timeout]\n", name);
+}
+
+int
+main(int argc, char **argv)
+{
+    const char *path = PROTOCOL_DEFAULT_SOCKET;
+    long threads = sysconf(_SC_NPROCESSORS_ONLN);
+    int capacity = 65536;
+    long timeout = 0;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "s:t:c:T:h")) != -1) {
+        switch (opt) {
+        case 's':
+            path = optarg;
+            break;
+
+        case 't':
+            threads = atol(optarg);
+            break;
+
+        case 'c':
+            capacity = atoi(optarg);
+            break;
+
+        case 'T':
+            timeout = atol(optarg);
+            break;
+
+        default:
+            usage(argv[0]);
+            return opt == 'h' ? 0 : 1;
+        }
+    }
+
+    if (threads < 1 || capacity < 1 || timeout < 0) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    city_prepare_tables(PROTOCOL_MAX_SIZE);
+    server_t server;
+    server.listen_fd = listen_on(path);
+
+    if (server.listen_fd < 0) {
+        return 1;
+    }
+
+    server.threads = (int) threads;
+    server.timeout = timeout;
+    server.workers = malloc((size_t) threads * sizeof(pthread_t));
+    server.stats = calloc((size_t) threads, sizeof(worker_stats_t));
+    server.active = malloc((size_t) threads * sizeof(int));
+    worker_arg_t *args = malloc((size_t) threads * sizeof(worker_arg_t));
+    server.queue_capacity = 64;
+    server.queue = malloc((size_t) server.queue_capacity * sizeof(int));
+    server.queue_head = 0;
+    server.queue_count = 0;
+    server.stop = false;
+    server.cache = cache_new(capacity);
+    pthread_mutex_init(&server.lock, NULL);
+    pthread_cond_init(&server.ready, NULL);
+    pthread_mutex_init(&server.cache_lock, NULL);
+
+    /* Сигналы завершения должны прерывать accept() главного потока, поэтому обработчики
+     * ставятся без SA_RESTART, а в потоках-обработчиках сигналы заблокированы. */
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = on_signal;
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+    signal(SIGPIPE, SIG_IGN);
+
+    sigset_t mask, old;
+    sigemptyset(&mask);
+    sigaddset(&mask, SIGINT);
+    sigaddset(&mask, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &mask, &old);
+
+    for (int i = 0; i < server.threads; i++) {
+        server.active[i] = -1;
+        args[i].server = &server;
+        args[i].id = i;
+        pthread_create(&server.workers[i], NULL, worker, &args[i]);
+    }
+
+    pthread_sigmask(SIG_SETMASK, &old, NULL);
+    fprintf(stderr, "Listening on %s with %d threads.\n", path, server.threads);
+
+    while (!interrupted) {
+        int fd = accept(server.listen_fd, NULL, NULL);
+
+        if (fd < 0) {
+            if (errno != EINTR) {
+                perror("accept");
+            }
+
+            continue;
+        }
+
+        enqueue(&server, fd);
+    }
+
+    /* Завершение: ждущие в очереди соединения закрываются, а обслуживаемые прерываются. */
+    pthread_mutex_lock(&server.lock);
+    server.stop = true;
+
+    for (int i = 0; i < server.queue_count; i++) {
+        close(server.queue[(server.queue_head + i) % server.queue_capacity]);
+    }
+
+    server.queue_count = 0;
+
+    for (int i = 0; i < server.threads; i++) {
+        if (server.active[i] >= 0) {
+            shutdown(server.active[i], SHUT_RDWR);
+        }
+    }
+
+    pthread_cond_broadcast(&server.ready);
+    pthread_mutex_unlock(&server.lock);
+
+    worker_stats_t total = {0, 0, 0, 0, 0};
+
+    for (int i = 0; i < server.threads; i++) {
+        pthread_join(server.workers[i], NULL);
+        total.requests += server.stats[i].requests;
+        total.solved += server.stats[i].solved;
+        total.cached += server.stats[i].cached;
+        total.rejected += server.stats[i].rejected;
+        total.timeouts += server.stats[i].timeouts;
+    }
+
+    cache_stats_t cs;
+    cache_get_stats(server.cache, &cs);
+    fprintf(stderr, "Requests %llu, solved %llu, from cache %llu, rejected %llu, timeouts %llu.\n",
+            total.requests, total.solved, total.cached, total.rejected, total.timeouts);
+    fprintf(stderr, "Cache entries %d of %d, evictions %llu.\n",
+            cs.entries, cs.capacity, cs.evictions);
+
+    close(server.listen_fd);
+    unlink(path);
+    cache_free(server.cache);
+    pthread_mutex_destroy(&server.cache_lock);
+    pthread_cond_destroy(&server.ready);
+    pthread_mutex_destroy(&server.lock);
+    free(server.queue);
+    free(args);
+    free(server.active);
+    free(server.stats);
+    free(server.workers);
+    return 0;
+}
@@ -0,0 +1,322 @@
+/* utf-8 */
+
+/**
+ * @file
+ * @brief Решение головоломки с контрольными точками.
+ * @details Незаконченный поиск периодически сохраняется в файл функцией city_search_save(),
+ * а также по сигналу SIGUSR1. По SIGINT и SIGTERM поиск сохраняется и программа завершается,
+ * поэтому долгое решение переживает перезапуск и может быть продолжено на другой машине.
+ * Файл записывается атомарно: данные пишутся во временный файл рядом, сбрасываются на диск и
+ * временный файл переименовывается поверх старого, так что на диске всегда остаётся целая
+ * контрольная точка. После решения файл удаляется.
+ *
+ * @verbatim
+   skyskrapers-solve -c file [-i seconds] [-m methods] [-v] [size clue ...]
+
+   -c  файл контрольной точки
+   -i  период сохранения в секундах, 0 - только по сигналу
+   -m  методы решения, битовые флаги _solve_methods
+   -v  выводить сообщения решателя
+
+   Без подсказок решение продолжается с контрольной точки.
+   @endverbatim
+ *
+ * @date создан 19.10.2026
+ * @author Nick Egorrov
+ * @copyright http://www.apache.org/licenses/LICENSE-2.0
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <libgen.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include "skyskrapers/skyskrapers.h"
+#include "skyskrapers/city.h"
+#include "skyskrapers/tower.h"
+
+/** Количество шагов поиска между проверками флагов сигналов. */
+#define STEPS 1024
+
+enum _exit_codes {
+    EXIT_SOLVED = 0,
+    EXIT_UNSOLVABLE = 1,
+    EXIT_ERROR = 2,
+    EXIT_SUSPENDED = 3
+};
+
+static volatile sig_atomic_t checkpoint = 0;
+static volatile sig_atomic_t interrupted = 0;
+
+static void
+on_signal(int sig)
+{
+    if (sig == SIGINT || sig == SIGTERM) {
+        interrupted = 1;
+    } else {
+        checkpoint = 1;
+    }
+}
+
+static bool
+write_all(int fd, const unsigned char *buf, size_t size)
+{
+    while (size > 0) {
+        ssize_t written = write(fd, buf, size);
+
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            return false;
+        }
+
+        buf += written;
+        size -= (size_t) written;
+    }
+
+    return true;
+}
+
+/** Сбрасывает на диск каталог файла @p path, чтобы переименование пережило сбой питания. */
+static void
+sync_dir(const char *path)
+{
+    char *copy = strdup(path);
+    int fd = copy != NULL ? open(dirname(copy), O_RDONLY) : -1;
+
+    if (fd >= 0) {
+        fsync(fd);
+        close(fd);
+    }
+
+    free(copy);
+}
+
+static bool
+save(const city_t *city, const char *path)
+{
+    size_t size = city_search_save(city, NULL, 0);
+    unsigned char *buf = malloc(size);
+    size_t tmp_size = strlen(path) + 5;
+    char *tmp = malloc(tmp_size);
+
+    if (buf == NULL || tmp == NULL) {
+        free(buf);
+        free(tmp);
+        return false;
+    }
+
+    city_search_save(city, buf, size);
+    snprintf(tmp, tmp_size, "%s.tmp", path);
+    int fd = open(tmp, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    bool ok = fd >= 0 && write_all(fd, buf, size) && fsync(fd) == 0;
+
+    if (fd >= 0 && close(fd) != 0) {
+        ok = false;
+    }
+
+    if (ok && rename(tmp, path) != 0) {
+        ok = false;
+    }
+
+    if (!ok) {
+        perror(tmp);
+        unlink(tmp);
+    } else {
+        sync_dir(path);
+    }
+
+    free(buf);
+    free(tmp);
+    return ok;
+}
+
+static city_t *
+load(const char *path)
+{
+    FILE *io = fopen(path, "rb");
+
+    if (io == NULL) {
+        perror(path);
+        return NULL;
+    }
+
+    size_t capacity = 4096, size = 0;
+    unsigned char *buf = malloc(capacity);
+
+    while (buf != NULL) {
+        size += fread(buf + size, 1, capacity - size, io);
+
+        if (size < capacity) {
+            break;
+        }
+
+        capacity *= 2;
+        unsigned char *bigger = realloc(buf, capacity);
+
+        if (bigger == NULL) {
+            free(buf);
+        }
+
+        buf = bigger;
+    }
+
+    bool failed = ferror(io) != 0;
+    fclose(io);
+    city_t *city = buf != NULL && !failed ? city_search_load(buf, size) : NULL;
+    free(buf);
+
+    if (city == NULL) {
+        fprintf(stderr, "%s: damaged checkpoint\n", path);
+    }
+
+    return city;
+}
+
+static city_t *
+create(int argc, char **argv)
+{
+    int size = atoi(argv[0]);
+
+    if (size < CITY_MIN_SIZE || size > CITY_MAX_SIZE) {
+        fprintf(stderr, "Size must be from %d to %d\n", CITY_MIN_SIZE, CITY_MAX_SIZE);
+        return NULL;
+    }
+
+    if (argc != 1 + 4 * size) {
+        fprintf(stderr, "Expected size and %d clues\n", 4 * size);
+        return NULL;
+    }
+
+    int clues[4 * CITY_MAX_SIZE];
+
+    for (int i = 0; i < 4 * size; i++) {
+        clues[i] = atoi(argv[1 + i]);
+    }
+
+    city_t *city = city_new(size);
+
+    if (!city_load_clues(city, clues)) {
+        fprintf(stderr, "Clues are not consistent\n");
+        city_free(city);
+        return NULL;
+    }
+
+    return city;
+}
+
+static void
+print(const city_t *city)
+{
+    for (int y = 0; y < city->size; y++) {
+        for (int x = 0; x < city->size; x++) {
+            printf("%s%d", x == 0 ? "" : " ", tower_get_height(&city->towers[x + y * city->size]));
+        }
+
+        printf("\n");
+    }
+}
+
+static void
+usage(const char *name)
+{
+    fprintf(stderr, "Usage: %s -c file [-i seconds] [-m methods] [-v] [size clue ...]\n", name);
+}
+
+int
+main(int argc, char **argv)
+{
+    const char *path = NULL;
+    long interval = 60;
+    unsigned int methods = METHOD_DEFAULT;
+    bool verbose = false;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "c:i:m:vh")) != -1) {
+        switch (opt) {
+        case 'c':
+            path = optarg;
+            break;
+
+        case 'i':
+            interval = atol(optarg);
+            break;
+
+        case 'm':
+            methods = (unsigned int) strtoul(optarg, NULL, 0);
+            break;
+
+        case 'v':
+            verbose = true;
+            break;
+
+        default:
+            usage(argv[0]);
+            return opt == 'h' ? EXIT_SOLVED : EXIT_ERROR;
+        }
+    }
+
+    if (path == NULL || interval < 0) {
+        usage(argv[0]);
+        return EXIT_ERROR;
+    }
+
+    city_t *city = optind < argc ? create(argc - optind, argv + optind) : load(path);
+
+    if (city == NULL) {
+        return EXIT_ERROR;
+    }
+
+    city_set_log(city, verbose ? stderr : NULL);
+    city_set_methods(city, methods);
+
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = on_signal;
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+    sigaction(SIGUSR1, &sa, NULL);
+    sigaction(SIGALRM, &sa, NULL);
+
+    if (interval > 0) {
+        struct itimerval timer = {{interval, 0}, {interval, 0}};
+        setitimer(ITIMER_REAL, &timer, NULL);
+    }
+
+    while (!city_solve_run(city, STEPS)) {
+        if (interrupted) {
+            int code = save(city, path) ? EXIT_SUSPENDED : EXIT_ERROR;
+            city_free(city);
+            return code;
+        }
+
+        if (checkpoint) {
+            checkpoint = 0;
+            save(city, path);
+        }
+    }
+
+    int code = EXIT_UNSOLVABLE;
+
+    if (city_solve_result(city) == SOLVE_SOLVED) {
+        print(city);
+        code = EXIT_SOLVED;
+    } else {
+        printf("No solution\n");
+    }
+
+    if (unlink(path) != 0 && errno != ENOENT) {
+        perror(path);
+    }
+
+    city_free(city);
+    return code;
+}